@@ -0,0 +1,62 @@
+/*
+ * Support for -l:libdosenv.a, which makes the startup code in
+ * dos-models-crt0.S leave the MS-DOS environment block alone rather than
+ * copy it onto the stack.  The first getenv (.), setenv (, , ), etc. then
+ * builds `environ' on the heap, straight from the environment segment.
+ *
+ * Until then, `environ' --- and the envp passed to main (...) --- are
+ * empty.
+ */
+
+#include <reent.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef MK_FP
+#define MK_FP(s, o) ((void __far *) ((unsigned long) (unsigned) (s) << 16 | \
+				     (unsigned) (o)))
+#endif
+
+extern char **environ;
+extern void (*__env_fill_hook) (struct _reent *);
+
+/* Tested for by the startup code.  */
+__asm (".globl __msdos_lazy_environ; .set __msdos_lazy_environ, 1");
+
+static void
+fill_environ (struct _reent *r)
+{
+  const char __far *env
+    = MK_FP (*(const unsigned __far *) MK_FP (_psp, 0x2c), 0);
+  size_t size = 0, n = 0, i;
+  char **vec, *str;
+
+  while (env[size])
+    {
+      while (env[size++]);
+      ++n;
+    }
+
+  vec = _malloc_r (r, (n + 1) * sizeof (char *) + size);
+  if (! vec)
+    return;
+
+  str = (char *) (vec + n + 1);
+  for (i = 0; i < size; ++i)
+    str[i] = env[i];
+
+  for (i = 0; i < n; ++i)
+    {
+      vec[i] = str;
+      str += strlen (str) + 1;
+    }
+  vec[n] = NULL;
+
+  environ = vec;
+}
+
+static void __attribute__ ((__constructor__))
+install_fill_environ (void)
+{
+  __env_fill_hook = fill_environ;
+}
@@ -0,0 +1,144 @@
+/*
+ * Versions of read (, , ) and write (, , ) for ELKS which take a far
+ * buffer, so that a program can fill or drain a buffer outside its own
+ * data segment without going through a near buffer.
+ *
+ * The ELKS kernel reaches user memory through the data segment that was
+ * in force at the `int $0x80', so we simply point %ds at the caller's
+ * buffer for the duration of the system call.  If the kernel refuses such
+ * a buffer (EFAULT), we remember that and thereafter bounce the data
+ * through a near buffer on the stack, one chunk at a time.
+ *
+ * The buffer must not wrap around the end of its segment.
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include "elks-syscalls.h"
+
+#undef errno
+extern int errno;
+
+extern int read (int, char *, int);
+extern int write (int, char *, int);
+
+#ifndef FP_SEG
+#define FP_SEG(x) \
+  __builtin_ia16_selector ((unsigned)((unsigned long)(void __far *)(x) >> 16))
+#endif
+#ifndef FP_OFF
+#define FP_OFF(x) ((unsigned)(unsigned long)(void __far *)(x))
+#endif
+
+#define BOUNCE_SIZE 256
+
+static int far_io_refused = 0;
+
+static int
+far_syscall (int nr, int fd, void __far *buf, unsigned count)
+{
+  int ret;
+  __asm volatile ("int $0x80"
+		  : "=a" (ret)
+		  : "0" (nr), "b" (fd), "c" (FP_OFF (buf)), "d" (count),
+		    "Rds" (FP_SEG (buf))
+		  : "cc", "memory");
+  return ret;
+}
+
+static int
+near_p (const void __far *buf)
+{
+  char dummy;
+  return FP_SEG (buf) == FP_SEG (&dummy);
+}
+
+int
+_readfar (int fd, void __far *buf, unsigned count)
+{
+  char bounce[BOUNCE_SIZE];
+  char __far *p = buf;
+  unsigned done = 0;
+
+  if (near_p (buf))
+    return read (fd, (char *) FP_OFF (buf), count);
+
+  if (! far_io_refused)
+    {
+      int ret = far_syscall (__NR_read, fd, buf, count);
+      if (ret != -EFAULT)
+	{
+	  if (ret < 0)
+	    {
+	      errno = -ret;
+	      ret = -1;
+	    }
+	  return ret;
+	}
+      far_io_refused = 1;
+    }
+
+  while (done < count)
+    {
+      unsigned chunk = count - done, i;
+      int ret;
+
+      if (chunk > BOUNCE_SIZE)
+	chunk = BOUNCE_SIZE;
+      ret = read (fd, bounce, chunk);
+      if (ret < 0)
+	return done ? (int) done : -1;
+      for (i = 0; i < (unsigned) ret; ++i)
+	p[done + i] = bounce[i];
+      done += ret;
+      if ((unsigned) ret < chunk)
+	break;
+    }
+
+  return done;
+}
+
+int
+_writefar (int fd, const void __far *buf, unsigned count)
+{
+  char bounce[BOUNCE_SIZE];
+  const char __far *p = buf;
+  unsigned done = 0;
+
+  if (near_p (buf))
+    return write (fd, (char *) FP_OFF (buf), count);
+
+  if (! far_io_refused)
+    {
+      int ret = far_syscall (__NR_write, fd, (void __far *) buf, count);
+      if (ret != -EFAULT)
+	{
+	  if (ret < 0)
+	    {
+	      errno = -ret;
+	      ret = -1;
+	    }
+	  return ret;
+	}
+      far_io_refused = 1;
+    }
+
+  while (done < count)
+    {
+      unsigned chunk = count - done, i;
+      int ret;
+
+      if (chunk > BOUNCE_SIZE)
+	chunk = BOUNCE_SIZE;
+      for (i = 0; i < chunk; ++i)
+	bounce[i] = p[done + i];
+      ret = write (fd, bounce, chunk);
+      if (ret < 0)
+	return done ? (int) done : -1;
+      done += ret;
+      if ((unsigned) ret < chunk)
+	break;
+    }
+
+  return done;
+}
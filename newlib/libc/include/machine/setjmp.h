@@ -92,7 +92,7 @@ _BEGIN_STD_C
 
 #ifdef __ia16__
 /* We save ax, bx, cx, dx, si, di, bp, sp, ip, es.  Also save cs for the
-   medium memory model.  */
+   medium memory model.  _setjmp skips ax, bx, cx, and dx.  */
 # ifdef __IA16_CMODEL_IS_FAR_TEXT
 #   define _JBLEN 11
 # else
@@ -406,6 +406,15 @@ typedef	int jmp_buf[_JBLEN];
 #endif
 #endif
 
+#if defined(__ia16__) && !defined(__ELKS__) && __MISC_VISIBLE
+/* _setjmp/_longjmp save and restore only the registers which a function
+   call preserves, and so are cheaper than setjmp/longjmp.  They use the
+   same jmp_buf layout, so either setjmp may be paired with either
+   longjmp.  */
+extern int _setjmp (jmp_buf);
+extern void _longjmp (jmp_buf, int) __attribute__ ((__noreturn__));
+#endif
+
 _END_STD_C
 
 #if (defined(__CYGWIN__) || defined(__rtems__)) && __POSIX_VISIBLE
@@ -72,6 +72,23 @@ typedef struct __db DB;   /* Forward-declaration */
 typedef DB DBM;
 #define	dbm_pagfno(a)	DBM_PAGFNO_NOT_AVAILABLE
 
+#if __BSD_VISIBLE
+/* Tuning for dbm_open_hints(); a zero member selects the default. */
+struct dbm_hints {
+	unsigned int	cachesize;	/* bytes of page buffers */
+	unsigned int	bsize;		/* page size of a new database */
+	unsigned int	readahead;	/* overflow pages read with a bucket */
+};
+
+/* Buffer pool counters returned by dbm_getstats(). */
+struct dbm_stats {
+	unsigned long	hits;		/* pages found in the buffer pool */
+	unsigned long	misses;		/* pages read on demand */
+	unsigned long	readahead;	/* overflow pages read ahead */
+	unsigned long	splits;		/* bucket splits */
+};
+#endif
+
 __BEGIN_DECLS
 int	 dbm_clearerr(DBM *);
 void	 dbm_close(DBM *);
@@ -84,6 +101,8 @@ DBM	*dbm_open(const char *, int, mode_t);
 int	 dbm_store(DBM *, datum, datum, int);
 #if __BSD_VISIBLE
 int	 dbm_dirfno(DBM *);
+int	 dbm_getstats(DBM *, struct dbm_stats *);
+DBM	*dbm_open_hints(const char *, int, mode_t, const struct dbm_hints *);
 #endif
 __END_DECLS
 
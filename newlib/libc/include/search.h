@@ -34,6 +34,29 @@ typedef struct node {
 	char         *key;
 	struct node  *llink, *rlink;
 } node_t;
+
+/*
+ * The tree is kept AVL-balanced without growing the node: nodes are at
+ * least 2-byte aligned, so the low bit of llink is set when the left
+ * subtree is one level taller than the right one, and the low bit of
+ * rlink when the right subtree is.  Links must be read through __TPTR.
+ * The root pointer itself never carries a tag.
+ */
+#define	__TBAL		((__uintptr_t) 1)
+#define	__TPTR(p)	((node_t *) ((__uintptr_t) (p) & ~__TBAL))
+#define	__TTAG(p)	((__uintptr_t) (p) & __TBAL)
+#define	__TLINK(n, d)	((d) ? &(n)->rlink : &(n)->llink)
+#define	__TSETLINK(lp, p) \
+	(*(lp) = (node_t *) ((__uintptr_t) (p) | __TTAG (*(lp))))
+#define	__TBALANCE(n)	((int) __TTAG ((n)->rlink) - (int) __TTAG ((n)->llink))
+#define	__TSETBAL(n, b) \
+	((n)->llink = (node_t *) ((__uintptr_t) __TPTR ((n)->llink) | ((b) < 0)), \
+	 (n)->rlink = (node_t *) ((__uintptr_t) __TPTR ((n)->rlink) | ((b) > 0)))
+
+/* An AVL tree filling the address space is less than 1.44 * bits tall. */
+#define	__TMAXDEPTH	(sizeof (void *) * 8 * 3 / 2)
+
+node_t	*__trotate(node_t *, int, int *);
 #endif
 
 struct hsearch_data
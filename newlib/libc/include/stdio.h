@@ -100,6 +100,8 @@ typedef _fpos64_t fpos64_t;
 
 /* _flags2 flags */
 #define	__SNLK  0x0001		/* stdio functions do not lock streams themselves */
+#define	__SMTMP	0x0002		/* tmpfile still held in memory */
+#define	__SSEQ	0x0004		/* buffer is ours to grow for sequential I/O */
 #define	__SWID	0x2000		/* true => stream orientation wide, false => byte, only valid if __SORD in _flags is true */
 
 /*
@@ -348,6 +350,8 @@ FILE *  popen (const char *, const char *);
 #if __BSD_VISIBLE
 void    setbuffer (FILE *, char *, int);
 int	setlinebuf (FILE *);
+size_t	tmpfile_memmax (size_t);
+char *	fgetln (FILE *__restrict, size_t *__restrict);
 #endif
 
 #if __MISC_VISIBLE || (__XSI_VISIBLE && __POSIX_VISIBLE < 200112)
@@ -411,6 +415,7 @@ FILE *	_fdopen_r (struct _reent *, int, const char *);
 int	_fflush_r (struct _reent *, FILE *);
 int	_fgetc_r (struct _reent *, FILE *);
 int	_fgetc_unlocked_r (struct _reent *, FILE *);
+char *  _fgetln_r (struct _reent *, FILE *__restrict, size_t *__restrict);
 char *  _fgets_r (struct _reent *, char *__restrict, int, FILE *__restrict);
 char *  _fgets_unlocked_r (struct _reent *, char *__restrict, int, FILE *__restrict);
 #ifdef _COMPILING_NEWLIB
@@ -525,6 +530,21 @@ int	_vsprintf_r (struct _reent *, char *__restrict, const char *__restrict, __VA
 int	_vsscanf_r (struct _reent *, const char *__restrict, const char *__restrict, __VALIST)
                _ATTRIBUTE ((__format__ (__scanf__, 3, 0)));
 
+#if __MISC_VISIBLE /* Newlib-specific */
+/* A printf format parsed once by printf_compile.  */
+typedef struct __printf_fmt printf_fmt_t;
+
+printf_fmt_t *	_printf_compile_r (struct _reent *, const char *);
+int	_vfprintf_compiled_r (struct _reent *, FILE *, const printf_fmt_t *, __VALIST);
+int	_memstream_reserve_r (struct _reent *, FILE *, size_t);
+#ifndef _REENT_ONLY
+printf_fmt_t *	printf_compile (const char *);
+int	fprintf_compiled (FILE *, const printf_fmt_t *, ...);
+int	vfprintf_compiled (FILE *, const printf_fmt_t *, __VALIST);
+int	memstream_reserve (FILE *, size_t);
+#endif
+#endif /* __MISC_VISIBLE */
+
 /* Other extensions.  */
 
 int	fpurge (FILE *);
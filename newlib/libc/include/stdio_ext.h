@@ -21,6 +21,7 @@ _BEGIN_STD_C
 
 void	 __fpurge (FILE *);
 int	 __fsetlocking (FILE *, int);
+unsigned long __fdirectcount (void);
 
 /* TODO:
 
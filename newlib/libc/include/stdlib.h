@@ -316,6 +316,24 @@ void	__bsd_qsort_r (void *__base, size_t __nmemb, size_t __size, void *__thunk,
 #  define qsort_r __bsd_qsort_r
 # endif
 #endif
+#if __BSD_VISIBLE
+int	heapsort (void *__base, size_t __nmemb, size_t __size, __compar_fn_t _compar);
+int	mergesort (void *__base, size_t __nmemb, size_t __size, __compar_fn_t _compar);
+int	radixsort (const unsigned char **__base, int __nmemb, const unsigned char *__table, unsigned __endbyte);
+int	sradixsort (const unsigned char **__base, int __nmemb, const unsigned char *__table, unsigned __endbyte);
+#endif
+#if __MISC_VISIBLE
+void	qsort_prefix_r (void *__base, size_t __nmemb, size_t __size, int (*_compar)(const void *, const void *, void *), void *__thunk);
+__uint16_t *bsearch_u16 (__uint16_t __key, const __uint16_t *__base, size_t __nmemb);
+__uint32_t *bsearch_u32 (__uint32_t __key, const __uint32_t *__base, size_t __nmemb);
+__uint64_t *bsearch_u64 (__uint64_t __key, const __uint64_t *__base, size_t __nmemb);
+void	eytzinger_u16 (__uint16_t *__dst, const __uint16_t *__src, size_t __nmemb);
+void	eytzinger_u32 (__uint32_t *__dst, const __uint32_t *__src, size_t __nmemb);
+void	eytzinger_u64 (__uint64_t *__dst, const __uint64_t *__src, size_t __nmemb);
+__uint16_t *bsearch_eytzinger_u16 (__uint16_t __key, const __uint16_t *__eyt, size_t __nmemb);
+__uint32_t *bsearch_eytzinger_u32 (__uint32_t __key, const __uint32_t *__eyt, size_t __nmemb);
+__uint64_t *bsearch_eytzinger_u64 (__uint64_t __key, const __uint64_t *__eyt, size_t __nmemb);
+#endif
 
 /* On platforms where long double equals double.  */
 #ifdef _HAVE_LONG_DOUBLE
@@ -38,6 +38,9 @@ typedef struct __lock * _LOCK_T;
 	class _LOCK_T lock = &__lock_ ## lock
 #define __LOCK_INIT_RECURSIVE(class,lock) __LOCK_INIT(class,lock)
 
+/* Nonzero while no thread but the initial one has been started.  */
+extern int __retarget_lock_single_threaded;
+
 extern void __retarget_lock_init(_LOCK_T *lock);
 #define __lock_init(lock) __retarget_lock_init(&lock)
 extern void __retarget_lock_init_recursive(_LOCK_T *lock);
@@ -232,6 +232,10 @@ struct __sFILE {
 #endif
   _mbstate_t _mbstate;	/* for wide char stdio functions. */
   int   _flags2;        /* for future use */
+
+  /* streams from __sfp, for _fwalk and reuse */
+  struct __sFILE *_lnext;	/* next open stream */
+  struct __sFILE *_lprev;	/* previous open stream, or next free one */
 };
 
 #ifdef __CUSTOM_FILE_IO__
@@ -286,6 +290,10 @@ struct __sFILE64 {
   _flock_t _lock;	/* for thread-safety locking */
 #endif
   _mbstate_t _mbstate;	/* for wide char stdio functions. */
+
+  /* streams from __sfp, for _fwalk and reuse */
+  struct __sFILE64 *_lnext;	/* next open stream */
+  struct __sFILE64 *_lprev;	/* previous open stream, or next free one */
 };
 typedef struct __sFILE64 __FILE;
 #else
@@ -820,6 +828,7 @@ extern struct _reent *_impure_ptr __ATTRIBUTE_IMPURE_PTR__;
 extern struct _reent *const _global_impure_ptr __ATTRIBUTE_IMPURE_PTR__;
 
 void _reclaim_reent (struct _reent *);
+void _mprec_trim_r (struct _reent *);
 
 /* #define _REENT_ONLY define this to get only reentrant routines */
 
@@ -5,6 +5,11 @@
 # ifdef __MSDOS__
 extern unsigned _psp;
 # endif	/* __MSDOS__ */
+# ifdef __ELKS__
+/* read (, , ) and write (, , ) on a buffer outside the data segment.  */
+extern int _readfar (int, void __far *, unsigned);
+extern int _writefar (int, const void __far *, unsigned);
+# endif	/* __ELKS__ */
 #endif 	/* !__STRICT_ANSI__ */
 
 #endif	/* _MACHSTDLIB_H_ */
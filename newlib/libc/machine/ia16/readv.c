@@ -0,0 +1,102 @@
+/*
+ * readv (, , ) for MS-DOS and ELKS, on top of _read_r (, , , ).
+ *
+ * Runs of short pieces are read with a single call into a small buffer on
+ * the stack and then scattered, while pieces too big for that buffer are
+ * read straight into the caller's memory.  We stop at the first short
+ * read, as a real readv (, , ) would.
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <reent.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#ifndef SSIZE_MAX
+#define SSIZE_MAX ((ssize_t) ((size_t) -1 >> 1))
+#endif
+
+#define SCATTER_SIZE 128
+
+ssize_t
+_readv_r (struct _reent *r, int fd, const struct iovec *iov, int iovcnt)
+{
+  char scatter[SCATTER_SIZE];
+  size_t sum = 0;
+  ssize_t total = 0, got;
+  int i, j;
+
+  if (iovcnt <= 0 || iovcnt > IOV_MAX)
+    {
+      r->_errno = EINVAL;
+      return -1;
+    }
+
+  for (i = 0; i < iovcnt; ++i)
+    {
+      if (iov[i].iov_len > (size_t) SSIZE_MAX - sum)
+	{
+	  r->_errno = EINVAL;
+	  return -1;
+	}
+      sum += iov[i].iov_len;
+    }
+
+  i = 0;
+  while (i < iovcnt)
+    {
+      size_t run = 0, want;
+      const char *from;
+
+      /* Collect as many following short pieces as fit into our buffer.  */
+      for (j = i; j < iovcnt && iov[j].iov_len <= SCATTER_SIZE - run; ++j)
+	run += iov[j].iov_len;
+
+      if (j == i)
+	{
+	  /* A single big piece: read it in place.  */
+	  want = iov[i].iov_len;
+	  got = _read_r (r, fd, iov[i].iov_base, want);
+	  if (got < 0)
+	    return total ? total : -1;
+	  total += got;
+	  if ((size_t) got != want)
+	    break;
+	  ++i;
+	  continue;
+	}
+
+      if (run == 0)
+	{
+	  i = j;
+	  continue;
+	}
+
+      got = _read_r (r, fd, scatter, run);
+      if (got < 0)
+	return total ? total : -1;
+      total += got;
+
+      for (from = scatter; i < j && got > 0; ++i)
+	{
+	  size_t n = iov[i].iov_len;
+	  if (n > (size_t) got)
+	    n = got;
+	  memcpy (iov[i].iov_base, from, n);
+	  from += n;
+	  got -= n;
+	}
+
+      if ((size_t) (from - scatter) != run)
+	break;
+    }
+
+  return total;
+}
+
+ssize_t
+readv (int fd, const struct iovec *iov, int iovcnt)
+{
+  return _readv_r (_REENT, fd, iov, iovcnt);
+}
@@ -53,4 +53,8 @@
 # undef __need_PATH_MAX
 # undef __need__PATH_MAX
 
+# if ! defined IOV_MAX && defined _SYS_SYSLIMITS_H_
+#   define IOV_MAX	1024		/* max elements in i/o vector */
+# endif
+
 #endif  /* ! _SYS_SYSLIMITS_H_ || __need_... */
@@ -0,0 +1,23 @@
+#ifndef _SYS_UIO_H_
+#define _SYS_UIO_H_
+
+#include <sys/cdefs.h>
+#include <sys/types.h>
+
+__BEGIN_DECLS
+
+struct iovec {
+  void   *iov_base;
+  size_t  iov_len;
+};
+
+ssize_t readv (int, const struct iovec *, int);
+ssize_t writev (int, const struct iovec *, int);
+
+struct _reent;
+ssize_t _readv_r (struct _reent *, int, const struct iovec *, int);
+ssize_t _writev_r (struct _reent *, int, const struct iovec *, int);
+
+__END_DECLS
+
+#endif /* _SYS_UIO_H_ */
@@ -0,0 +1,97 @@
+/*
+ * writev (, , ) for MS-DOS and ELKS, on top of _write_r (, , , ).
+ *
+ * Neither system has a gathering write call, so we do the next best thing:
+ * runs of short pieces are collected in a small buffer on the stack and
+ * written out with a single call, while pieces too big for that buffer
+ * are written straight from the caller's memory.
+ *
+ * This lives in newlib rather than in the BSPs, since stdio's unbuffered
+ * output path calls _writev_r (, , , ) in every ia16 configuration.
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <reent.h>
+#include <string.h>
+#include <sys/uio.h>
+
+#ifndef SSIZE_MAX
+#define SSIZE_MAX ((ssize_t) ((size_t) -1 >> 1))
+#endif
+
+#define GATHER_SIZE 128
+
+static ssize_t
+flush (struct _reent *r, int fd, const char *buf, size_t n, ssize_t *total)
+{
+  ssize_t w = _write_r (r, fd, buf, n);
+  if (w < 0)
+    return *total ? 0 : -1;
+  *total += w;
+  return (size_t) w == n;
+}
+
+ssize_t
+_writev_r (struct _reent *r, int fd, const struct iovec *iov, int iovcnt)
+{
+  char gather[GATHER_SIZE];
+  size_t fill = 0, sum = 0;
+  ssize_t total = 0, ok;
+  int i;
+
+  if (iovcnt <= 0 || iovcnt > IOV_MAX)
+    {
+      r->_errno = EINVAL;
+      return -1;
+    }
+
+  for (i = 0; i < iovcnt; ++i)
+    {
+      if (iov[i].iov_len > (size_t) SSIZE_MAX - sum)
+	{
+	  r->_errno = EINVAL;
+	  return -1;
+	}
+      sum += iov[i].iov_len;
+    }
+
+  for (i = 0; i < iovcnt; ++i)
+    {
+      const char *base = iov[i].iov_base;
+      size_t len = iov[i].iov_len;
+
+      if (len <= GATHER_SIZE - fill)
+	{
+	  memcpy (gather + fill, base, len);
+	  fill += len;
+	  continue;
+	}
+
+      if (fill)
+	{
+	  if ((ok = flush (r, fd, gather, fill, &total)) <= 0)
+	    return ok ? ok : total;
+	  fill = 0;
+	}
+
+      if (len < GATHER_SIZE)
+	{
+	  memcpy (gather, base, len);
+	  fill = len;
+	}
+      else if ((ok = flush (r, fd, base, len, &total)) <= 0)
+	return ok ? ok : total;
+    }
+
+  if (fill && (ok = flush (r, fd, gather, fill, &total)) < 0)
+    return ok;
+
+  return total;
+}
+
+ssize_t
+writev (int fd, const struct iovec *iov, int iovcnt)
+{
+  return _writev_r (_REENT, fd, iov, iovcnt);
+}
@@ -20,6 +20,8 @@ INDEX
 	__lock___dd_hash_mutex
 INDEX
 	__lock___arc4random_mutex
+INDEX
+	__retarget_lock_single_threaded
 
 INDEX
 	__retarget_lock_init
@@ -53,6 +55,7 @@ SYNOPSIS
 	struct __lock __lock___tz_mutex;
 	struct __lock __lock___dd_hash_mutex;
 	struct __lock __lock___arc4random_mutex;
+	int __retarget_lock_single_threaded;
 
 	void __retarget_lock_init (_LOCK_T * <[lock_ptr]>);
 	void __retarget_lock_init_recursive (_LOCK_T * <[lock_ptr]>);
@@ -77,6 +80,12 @@ an implementation for @strong{all} these routines and static locks.  If some
 routines or static locks are missing, the link will fail with doubly defined
 symbols.
 
+While <<__retarget_lock_single_threaded>> is nonzero, stdio does not lock
+streams at all.  The default implementation sets it for good.  A platform
+may define it as well, initialized to 1, and clear it before it starts the
+first thread other than the initial one; if it does not define it, stdio
+always locks.
+
 PORTABILITY
 These locking routines and static lock are newlib-specific.  Supporting OS
 subroutines are required for linking multi-threaded applications.
@@ -102,6 +111,8 @@ struct __lock __lock___tz_mutex;
 struct __lock __lock___dd_hash_mutex;
 struct __lock __lock___arc4random_mutex;
 
+int __retarget_lock_single_threaded = 1;
+
 void
 __retarget_lock_init (_LOCK_T *lock)
 {
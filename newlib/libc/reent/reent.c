@@ -27,6 +27,8 @@ int errno;
 
 #endif
 
+extern void __mprec_reclaim (struct _reent *);
+
 /* Interim cleanup code */
 
 void
@@ -51,25 +53,7 @@ _reclaim_reent (struct _reent *ptr)
       {
 #endif
       if (_REENT_MP_FREELIST(ptr))
-	{
-	  int i;
-	  for (i = 0; i < _Kmax; i++) 
-	    {
-	      struct _Bigint *thisone, *nextone;
-	
-	      nextone = _REENT_MP_FREELIST(ptr)[i];
-	      while (nextone)
-		{
-		  thisone = nextone;
-		  nextone = nextone->_next;
-		  _free_r (ptr, thisone);
-		}
-	    }    
-
-	  _free_r (ptr, _REENT_MP_FREELIST(ptr));
-	}
-      if (_REENT_MP_RESULT(ptr))
-	_free_r (ptr, _REENT_MP_RESULT(ptr));
+	__mprec_reclaim (ptr);
 #ifdef _REENT_SMALL
       }
 #endif
@@ -0,0 +1,93 @@
+/*
+ * Template for the typed binary searches in bsearch_u16.c, bsearch_u32.c
+ * and bsearch_u64.c.  The including file defines TYPE, the unsigned key
+ * type, and NAME(x), which appends the type suffix to x.
+ *
+ * The plain search is a lower-bound loop whose only data-dependent choice
+ * is a conditional add, which compilers turn into a conditional move
+ * rather than a branch that mispredicts half the time.  The Eytzinger
+ * layout stores the implicit search tree breadth first, so that the
+ * first levels share a few cache lines and each step can prefetch the
+ * nodes four levels further down.
+ */
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#ifdef __GNUC__
+#define PREFETCH(p)	__builtin_prefetch (p)
+#else
+#define PREFETCH(p)
+#endif
+
+TYPE *
+NAME (bsearch) (TYPE key,
+	const TYPE *base,
+	size_t nmemb)
+{
+  const TYPE *p = base, *end = base + nmemb;
+  size_t half;
+
+  if (nmemb == 0)
+    return NULL;
+
+  /* The first element not less than KEY is in [p, p + nmemb].  */
+  while (nmemb > 1)
+    {
+      half = nmemb / 2;
+      PREFETCH (p + half / 2);
+      PREFETCH (p + half + half / 2);
+      p += (p[half] < key) ? half : 0;
+      nmemb -= half;
+    }
+  p += *p < key;
+
+  return p < end && *p == key ? (TYPE *) p : NULL;
+}
+
+/* Fill DST from SRC in order, visiting DST as a tree rooted at K.  */
+static size_t
+NAME (eytzinger_fill) (TYPE *dst,
+	const TYPE *src,
+	size_t i,
+	size_t k,
+	size_t nmemb)
+{
+  if (k < nmemb)
+    {
+      i = NAME (eytzinger_fill) (dst, src, i, 2 * k + 1, nmemb);
+      dst[k] = src[i++];
+      i = NAME (eytzinger_fill) (dst, src, i, 2 * k + 2, nmemb);
+    }
+  return i;
+}
+
+void
+NAME (eytzinger) (TYPE *dst,
+	const TYPE *src,
+	size_t nmemb)
+{
+  NAME (eytzinger_fill) (dst, src, 0, 0, nmemb);
+}
+
+TYPE *
+NAME (bsearch_eytzinger) (TYPE key,
+	const TYPE *eyt,
+	size_t nmemb)
+{
+  /* K counts from 1 here, so that the children of K are 2K and 2K+1.  */
+  size_t k = 1;
+
+  while (k <= nmemb)
+    {
+      PREFETCH (eyt + 16 * k - 1);
+      k = 2 * k + (eyt[k - 1] < key);
+    }
+
+  /* Undo the right turns taken after the last left one.  */
+  while (k & 1)
+    k >>= 1;
+  k >>= 1;
+
+  return k != 0 && eyt[k - 1] == key ? (TYPE *) &eyt[k - 1] : NULL;
+}
@@ -0,0 +1,5 @@
+#include <stdint.h>
+
+#define TYPE		uint16_t
+#define NAME(x)		x##_u16
+#include "bsearch_typed.h"
@@ -0,0 +1,66 @@
+/*
+FUNCTION
+<<bsearch_u32>>, <<eytzinger_u32>>, <<bsearch_eytzinger_u32>>---search sorted integer tables
+
+INDEX
+	bsearch_u16
+INDEX
+	bsearch_u32
+INDEX
+	bsearch_u64
+INDEX
+	eytzinger_u16
+INDEX
+	eytzinger_u32
+INDEX
+	eytzinger_u64
+INDEX
+	bsearch_eytzinger_u16
+INDEX
+	bsearch_eytzinger_u32
+INDEX
+	bsearch_eytzinger_u64
+
+SYNOPSIS
+	#include <stdlib.h>
+	uint32_t *bsearch_u32(uint32_t <[key]>, const uint32_t *<[base]>,
+		size_t <[nmemb]>);
+	void eytzinger_u32(uint32_t *<[dst]>, const uint32_t *<[src]>,
+		size_t <[nmemb]>);
+	uint32_t *bsearch_eytzinger_u32(uint32_t <[key]>,
+		const uint32_t *<[eyt]>, size_t <[nmemb]>);
+
+DESCRIPTION
+<<bsearch_u32>> looks for <[key]> in the <[nmemb]> unsigned integers at
+<[base]>, which must be sorted in ascending order.  It gives the same
+answers as <<bsearch>> with a comparison of the integers, but calls no
+comparison function and does not branch on the result of each probe,
+which typically makes it two to three times as fast.
+
+<<eytzinger_u32>> copies the sorted array <[src]> to <[dst]> in
+``Eytzinger'' order: the middle element first, then the middles of each
+half, and so on, as in a binary heap.  <<bsearch_eytzinger_u32>> looks
+for <[key]> in an array laid out that way.  The first steps of every
+search then touch the same few cache lines, and later ones can be
+fetched ahead of time, which pays off for tables much larger than the
+cache.
+
+<<bsearch_u16>>, <<eytzinger_u16>> and <<bsearch_eytzinger_u16>>, and
+the <<_u64>> forms, do the same for 16- and 64-bit keys.
+
+RETURNS
+The search functions return a pointer to an element equal to <[key]>,
+or NULL if there is none.  If several elements are equal to <[key]>,
+<<bsearch_u32>> returns the first of them.
+
+PORTABILITY
+These functions are newlib extensions.
+
+No supporting OS subroutines are required.
+*/
+
+#include <stdint.h>
+
+#define TYPE		uint32_t
+#define NAME(x)		x##_u32
+#include "bsearch_typed.h"
@@ -0,0 +1,5 @@
+#include <stdint.h>
+
+#define TYPE		uint64_t
+#define NAME(x)		x##_u64
+#include "bsearch_typed.h"
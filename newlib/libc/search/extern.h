@@ -53,6 +53,11 @@ __uint32_t	 __log2(__uint32_t);
 int	 __put_page(HTAB *, char *, __uint32_t, int, int);
 void	 __reclaim_buf(HTAB *, BUFHEAD *);
 int	 __split_page(HTAB *, __uint32_t, __uint32_t);
+#ifdef HAVE_FILE_MMAP
+void	 __map_file(HTAB *);
+char	*__map_page(HTAB *, __uint32_t, int);
+void	 __unmap_file(HTAB *);
+#endif
 
 /* Default hash routine. */
 extern __uint32_t (*__default_hash)(const void *, size_t);
@@ -216,6 +216,12 @@ __hash_open (const char *file,
 		(void)memset(&hashp->mapp[0], 0, bpages * sizeof(__uint32_t *));
 	}
 
+#ifdef HAVE_FILE_MMAP
+	/* Read-only lookups can be served from a mapping of the file. */
+	if (!new_table && (flags & O_ACCMODE) == O_RDONLY)
+		__map_file(hashp);
+#endif
+
 	/* Initialize Buffer Manager */
 	if (info && info->cachesize)
 		__buf_init(hashp, info->cachesize);
@@ -458,6 +464,9 @@ hdestroy(hashp)
 	 */
 	if (__buf_free(hashp, 1, hashp->save_file))
 		save_errno = errno;
+#ifdef HAVE_FILE_MMAP
+	__unmap_file(hashp);
+#endif
 	if (hashp->dir) {
 		free(*hashp->dir);	/* Free initial segments */
 		/* Free extra segments */
@@ -897,6 +906,7 @@ __expand_table(hashp)
 		hashp->HIGH_MASK = new_bucket | hashp->LOW_MASK;
 	}
 	/* Relocate records to the new bucket */
+	hashp->nsplits++;
 	return (__split_page(hashp, old_bucket, new_bucket));
 }
 
@@ -132,6 +132,17 @@ typedef struct htab	 {		/* Memory resident data structure */
 					 * allocate */
 	BUFHEAD 	bufhead;	/* Header of buffer lru list */
 	SEGMENT 	*dir;		/* Hash Bucket directory */
+	int		readahead;	/* Overflow pages to read with a
+					 * bucket */
+	unsigned long	nhits;		/* Pages found in the buffer pool */
+	unsigned long	nmisses;	/* Pages read on demand */
+	unsigned long	nreadahead;	/* Pages read ahead */
+	unsigned long	nsplits;	/* Bucket splits */
+#ifdef HAVE_FILE_MMAP
+	char		*map;		/* Read-only mapping of the file */
+	size_t		maplen;		/* Length of the mapping */
+	char		*emptypage;	/* Stands in for unwritten pages */
+#endif
 } HTAB;
 
 /*
@@ -68,6 +68,7 @@ static char sccsid[] = "@(#)hash_buf.c	8.5 (Berkeley) 7/15/94";
 #include "extern.h"
 
 static BUFHEAD *newbuf(HTAB *, __uint32_t, BUFHEAD *);
+static void read_ahead(HTAB *, BUFHEAD *);
 
 /* Unlink B from its place in the lru */
 #define BUF_REMOVE(B) { \
@@ -86,6 +87,13 @@ static BUFHEAD *newbuf(HTAB *, __uint32_t, BUFHEAD *);
 #define	MRU	hashp->bufhead.next
 #define	LRU	hashp->bufhead.prev
 
+#ifdef HAVE_FILE_MMAP
+/* Buffers of a mapped table point into the mapping and own no page. */
+#define	MAPPED(H)	((H)->map != NULL)
+#else
+#define	MAPPED(H)	0
+#endif
+
 #define MRU_INSERT(B)	BUF_INSERT((B), &hashp->bufhead)
 #define LRU_INSERT(B)	BUF_INSERT((B), LRU)
 
@@ -142,17 +150,87 @@ __get_buf(hashp, addr, prev_bp, newpage)
 
 	if (!bp) {
 		bp = newbuf(hashp, addr, prev_bp);
-		if (!bp ||
-		    __get_page(hashp, bp->page, addr, !prev_bp, is_disk, 0))
+		if (!bp)
 			return (NULL);
-		if (!prev_bp)
+#ifdef HAVE_FILE_MMAP
+		/* A mapped table is read-only, so every page is on disk. */
+		if (hashp->map) {
+			if ((bp->page = __map_page(hashp, addr, !prev_bp)) == NULL)
+				goto fail;
+		} else
+#endif
+		if (__get_page(hashp, bp->page, addr, !prev_bp, is_disk, 0))
+			goto fail;
+		if (is_disk)
+			hashp->nmisses++;
+		if (!prev_bp) {
 			segp[segment_ndx] =
 			    (BUFHEAD *)((ptrdiff_t)bp | (intptr_t)is_disk_mask);
+			if (is_disk && hashp->readahead && !MAPPED(hashp))
+				read_ahead(hashp, bp);
+		}
 	} else {
+		hashp->nhits++;
 		BUF_REMOVE(bp);
 		MRU_INSERT(bp);
 	}
 	return (bp);
+
+fail:
+	/*
+	 * newbuf has already linked the buffer in.  Return it to the pool
+	 * empty, so that nothing reaches its page; a mapped buffer's page
+	 * is NULL here.
+	 */
+	if (prev_bp)
+		prev_bp->ovfl = NULL;
+	__reclaim_buf(hashp, bp);
+	return (NULL);
+}
+
+/*
+ * A bucket has just been read from disk.  Any lookup in it walks its
+ * overflow chain next, so read up to hashp->readahead of those pages now
+ * and let the walk be served from the buffer pool.  Failures are not
+ * reported here; the page is read again on demand and the error surfaces
+ * there.
+ */
+static void
+read_ahead(hashp, bp)
+	HTAB *hashp;
+	BUFHEAD *bp;
+{
+	BUFHEAD *xbp, *pbp;
+	__uint16_t *sp, n;
+	int cnt;
+
+	bp->flags |= BUF_PIN;
+	for (xbp = bp, cnt = hashp->readahead; cnt > 0; cnt--) {
+		sp = (__uint16_t *)xbp->page;
+		n = sp[0];
+		if (n < 2 || sp[n] != OVFLPAGE)
+			break;
+		if (xbp->ovfl && xbp->ovfl->addr == sp[n - 1]) {
+			xbp = xbp->ovfl;
+			continue;
+		}
+		pbp = xbp;
+		xbp = newbuf(hashp, sp[n - 1], pbp);
+		if (!xbp)
+			break;
+		if (__get_page(hashp, xbp->page, xbp->addr, 0, 1, 0)) {
+			/*
+			 * newbuf linked the buffer into the chain; take it
+			 * out again so that the chain does not lead to a
+			 * page that was never read.
+			 */
+			pbp->ovfl = NULL;
+			__reclaim_buf(hashp, xbp);
+			break;
+		}
+		hashp->nreadahead++;
+	}
+	bp->flags &= ~BUF_PIN;
 }
 
 /*
@@ -187,12 +265,15 @@ newbuf(hashp, addr, prev_bp)
 #ifdef PURIFY
 		memset(bp, 0xff, sizeof(BUFHEAD));
 #endif
-		if ((bp->page = (char *)malloc(hashp->BSIZE)) == NULL) {
+		if (MAPPED(hashp))
+			bp->page = NULL;
+		else if ((bp->page = (char *)malloc(hashp->BSIZE)) == NULL) {
 			free(bp);
 			return (NULL);
 		}
 #ifdef PURIFY
-		memset(bp->page, 0xff, hashp->BSIZE);
+		if (bp->page)
+			memset(bp->page, 0xff, hashp->BSIZE);
 #endif
 		if (hashp->nbufs)
 			hashp->nbufs--;
@@ -336,7 +417,7 @@ __buf_free(hashp, do_free, to_disk)
 		}
 		/* Check if we are freeing stuff */
 		if (do_free) {
-			if (bp->page)
+			if (bp->page && !MAPPED(hashp))
 				free(bp->page);
 			BUF_REMOVE(bp);
 			free(bp);
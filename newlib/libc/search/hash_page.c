@@ -53,6 +53,11 @@ static char sccsid[] = "@(#)hash_page.c	8.7 (Berkeley) 8/16/94";
  */
 
 #include <sys/types.h>
+#ifdef HAVE_FILE_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <reent.h>
+#endif
 
 #include <errno.h>
 #include <fcntl.h>
@@ -565,6 +570,93 @@ __get_page(hashp, p, bucket, is_bucket, is_disk, is_bitmap)
 	return (0);
 }
 
+#ifdef HAVE_FILE_MMAP
+/*
+ * Map a table opened read-only so that __get_buf can point its buffers
+ * straight into the file instead of reading pages.  Pages stored in the
+ * other byte order still have to be swapped, so such tables keep using
+ * __get_page, as does any table the system will not map.
+ */
+extern void
+__map_file(hashp)
+	HTAB *hashp;
+{
+#ifdef __USE_INTERNAL_STAT64
+	struct stat64 statbuf;
+#else
+	struct stat statbuf;
+#endif
+	void *p;
+
+	if (hashp->LORDER != DB_BYTE_ORDER ||
+#ifdef __USE_INTERNAL_STAT64
+	    _fstat64_r(_REENT, hashp->fp, &statbuf) ||
+#else
+	    _fstat_r(_REENT, hashp->fp, &statbuf) ||
+#endif
+	    statbuf.st_size <= 0 || statbuf.st_size != (size_t)statbuf.st_size)
+		return;
+	if ((hashp->emptypage = (char *)malloc(hashp->BSIZE)) == NULL)
+		return;
+	p = mmap(NULL, (size_t)statbuf.st_size, PROT_READ, MAP_SHARED,
+	    hashp->fp, 0);
+	if (p == MAP_FAILED) {
+		free(hashp->emptypage);
+		hashp->emptypage = NULL;
+		return;
+	}
+	PAGE_INIT(hashp->emptypage);
+	hashp->map = (char *)p;
+	hashp->maplen = (size_t)statbuf.st_size;
+}
+
+/*
+ * Return the address of a page in the mapping.  Pages that were never
+ * written, or lie past the end of the file, read as an empty page.
+ *
+ * Returns:
+ *	 address of the page
+ *	 NULL, with errno set to EFTYPE, if the file ends within the page
+ */
+extern char *
+__map_page(hashp, bucket, is_bucket)
+	HTAB *hashp;
+	__uint32_t bucket;
+	int is_bucket;
+{
+	size_t off;
+	int page;
+	char *p;
+
+	if (is_bucket)
+		page = BUCKET_TO_PAGE(bucket);
+	else
+		page = OADDR_TO_PAGE(bucket);
+	off = (size_t)page << hashp->BSHIFT;
+	if (off >= hashp->maplen)
+		return (hashp->emptypage);
+	if (hashp->maplen - off < (size_t)hashp->BSIZE) {
+		errno = EFTYPE;
+		return (NULL);
+	}
+	p = hashp->map + off;
+	if (!((__uint16_t *)p)[0])
+		return (hashp->emptypage);
+	return (p);
+}
+
+extern void
+__unmap_file(hashp)
+	HTAB *hashp;
+{
+	if (hashp->map) {
+		(void)munmap(hashp->map, hashp->maplen);
+		free(hashp->emptypage);
+		hashp->map = NULL;
+	}
+}
+#endif /* HAVE_FILE_MMAP */
+
 /*
  * Write page p to disk
  *
@@ -49,45 +49,130 @@ __RCSID("$NetBSD: hcreate.c,v 1.2 2001/02/19 21:26:04 ross Exp $");
 #endif
 
 #include <sys/types.h>
-#include <sys/queue.h>
 #include <errno.h>
 #include <search.h>
 #include <stdlib.h>
 #include <string.h>
 
 /*
- * DO NOT MAKE THIS STRUCTURE LARGER THAN 32 BYTES (4 ptrs on 64-bit
- * ptr machine) without adjusting MAX_BUCKETS_LG2 below.
+ * The table is open-addressed with linear probing.  Each slot keeps the
+ * full hash of its key next to a pointer to the entry, so a probe only
+ * calls strcmp when the hashes match.  Entries themselves are carved out
+ * of chunks and never move, since hsearch hands out pointers to them.
+ *
+ * Once the table is three quarters full, a table twice the size is
+ * allocated and the old slots are moved into it a few at a time on each
+ * later call, so that no single call pays for the whole rehash.  Until
+ * that is done, a key missing from the new table is looked up in the old.
  */
-struct internal_entry {
-	SLIST_ENTRY(internal_entry) link;
-	ENTRY ent;
+struct internal_slot {
+	size_t hash;
+	ENTRY *ent;				/* NULL if the slot is free */
 };
-SLIST_HEAD(internal_head, internal_entry);
 
-#define	MIN_BUCKETS_LG2	4
-#define	MIN_BUCKETS	(1 << MIN_BUCKETS_LG2)
+#define	ENTRIES_PER_CHUNK	16
+
+struct internal_chunk {
+	struct internal_chunk *next;
+	ENTRY ent[ENTRIES_PER_CHUNK];
+};
+
+struct internal_head {
+	struct internal_slot *slots;
+	size_t size;				/* always a power of two */
+	size_t count;				/* entries in the table */
+	struct internal_slot *old;		/* table being moved out of */
+	size_t oldsize;
+	size_t moved;				/* old slots moved so far */
+	struct internal_chunk *chunks;
+	size_t avail;				/* unused entries in chunks */
+};
+
+#define	MIN_SLOTS_LG2	4
+#define	MIN_SLOTS	(1 << MIN_SLOTS_LG2)
 
 /*
- * max * sizeof internal_entry must fit into size_t.
- * assumes internal_entry is <= 32 (2^5) bytes.
+ * max * sizeof internal_slot must fit into half of size_t.
+ * SLOT_LG2 rounds sizeof internal_slot up to a power of two; it is
+ * 4 bytes where size_t and pointers are 16 bits, as on ia16.
  */
+#define	SLOT_LG2	(sizeof (struct internal_slot) <= 4 ? 2 : \
+			 sizeof (struct internal_slot) <= 8 ? 3 : 4)
 #ifdef __MSP430X_LARGE__
 /* 20-bit size_t.  */
-#define	MAX_BUCKETS_LG2	(20 - 1 - 5)
+#define	MAX_SLOTS_LG2	(20 - 1 - SLOT_LG2)
 #else
-#define	MAX_BUCKETS_LG2	(sizeof (size_t) * 8 - 1 - 5)
+#define	MAX_SLOTS_LG2	(sizeof (size_t) * 8 - 1 - SLOT_LG2)
 #endif
-#define	MAX_BUCKETS	((size_t)1 << MAX_BUCKETS_LG2)
+#define	MAX_SLOTS	((size_t)1 << MAX_SLOTS_LG2)
+
+/* Old slots moved into the new table on each call while growing. */
+#define	MOVE_STEP	4
 
 /* Default hash function, from db/hash/hash_func.c */
 extern __uint32_t (*__default_hash)(const void *, size_t);
 
+/*
+ * Return the slot holding KEY, or the free slot where it would go.
+ * There is always at least one free slot.
+ */
+static struct internal_slot *
+probe(struct internal_slot *slots, size_t size, size_t hash, const char *key)
+{
+	size_t mask = size - 1;
+	size_t idx = hash & mask;
+	struct internal_slot *s;
+
+	for (;;) {
+		s = &slots[idx];
+		if (s->ent == NULL ||
+		    (s->hash == hash && strcmp(s->ent->key, key) == 0))
+			return s;
+		idx = (idx + 1) & mask;
+	}
+}
+
+/* Move up to N slots of the old table, if any, into the current one. */
+static void
+move_slots(struct internal_head *head, size_t n)
+{
+	struct internal_slot *s;
+
+	while (head->old != NULL && n-- > 0) {
+		s = &head->old[head->moved];
+		if (s->ent != NULL)
+			*probe(head->slots, head->size, s->hash, s->ent->key) = *s;
+		if (++head->moved == head->oldsize) {
+			free(head->old);
+			head->old = NULL;
+		}
+	}
+}
+
+/* Start moving into a table twice the size.  Return 0 if we cannot. */
+static int
+grow(struct internal_head *head)
+{
+	struct internal_slot *slots;
+
+	if (head->size >= MAX_SLOTS)
+		return 0;
+	slots = calloc(head->size * 2, sizeof *slots);
+	if (slots == NULL)
+		return 0;
+	head->old = head->slots;
+	head->oldsize = head->size;
+	head->moved = 0;
+	head->slots = slots;
+	head->size *= 2;
+	return 1;
+}
+
 int
 hcreate_r(size_t nel, struct hsearch_data *htab)
 {
-	size_t idx;
-	unsigned int p2;
+	struct internal_head *head;
+	size_t size;
 
 	/* Make sure this this isn't called when a table already exists. */
 	if (htab->htable != NULL) {
@@ -95,82 +180,77 @@ hcreate_r(size_t nel, struct hsearch_data *htab)
 		return 0;
 	}
 
-	/* If nel is too small, make it min sized. */
-	if (nel < MIN_BUCKETS)
-		nel = MIN_BUCKETS;
+	/*
+	 * Size the table so that nel entries leave it at most three
+	 * quarters full, within the limits; it grows later if need be.
+	 */
+	for (size = MIN_SLOTS; size < MAX_SLOTS && size / 4 * 3 < nel; )
+		size <<= 1;
 
-	/* If it's too large, cap it. */
-	if (nel > MAX_BUCKETS)
-		nel = MAX_BUCKETS;
-
-	/* If it's is not a power of two in size, round up. */
-	if ((nel & (nel - 1)) != 0) {
-		for (p2 = 0; nel != 0; p2++)
-			nel >>= 1;
-		nel = 1 << p2;
-	}
-	
 	/* Allocate the table. */
-	htab->htablesize = nel;
-	htab->htable = malloc(htab->htablesize * sizeof htab->htable[0]);
-	if (htab->htable == NULL) {
+	head = malloc(sizeof *head);
+	if (head == NULL) {
 		errno = ENOMEM;
 		return 0;
 	}
+	head->slots = calloc(size, sizeof head->slots[0]);
+	if (head->slots == NULL) {
+		free(head);
+		errno = ENOMEM;
+		return 0;
+	}
+	head->size = size;
+	head->count = 0;
+	head->old = NULL;
+	head->chunks = NULL;
+	head->avail = 0;
 
-	/* Initialize it. */
-	for (idx = 0; idx < htab->htablesize; idx++)
-		SLIST_INIT(&(htab->htable[idx]));
-
+	htab->htable = head;
+	htab->htablesize = size;
 	return 1;
 }
 
 void
 hdestroy_r(struct hsearch_data *htab)
 {
-#if 0
-	struct internal_entry *ie;
-	size_t idx;
-#endif
-	if (htab->htable == NULL)
+	struct internal_head *head = htab->htable;
+	struct internal_chunk *chunk;
+
+	if (head == NULL)
 		return;
 
-#if 0
-	for (idx = 0; idx < htab->htablesize; idx++) {
-		while (!SLIST_EMPTY(&(htab->htable[idx]))) {
-			ie = SLIST_FIRST(&(htab->htable[idx]));
-			SLIST_REMOVE_HEAD(&(htab->htable[idx]), link);
-                        free(ie->ent.key);
-			free(ie);
-		}
+	/* The keys belong to the caller and are not freed. */
+	while ((chunk = head->chunks) != NULL) {
+		head->chunks = chunk->next;
+		free(chunk);
 	}
-#endif
-	free(htab->htable);
+	free(head->old);
+	free(head->slots);
+	free(head);
 	htab->htable = NULL;
 }
 
 int
 hsearch_r(ENTRY item, ACTION action, ENTRY **retval, struct hsearch_data *htab)
 {
-	struct internal_head *head;
-	struct internal_entry *ie;
-	__uint32_t hashval;
-	size_t len;
-
-	len = strlen(item.key);
-	hashval = (*__default_hash)(item.key, len);
-
-        head = &(htab->htable[hashval & (htab->htablesize - 1)]);
-	ie = SLIST_FIRST(head);
-	while (ie != NULL) {
-		if (strcmp(ie->ent.key, item.key) == 0)
-			break;
-		ie = SLIST_NEXT(ie, link);
+	struct internal_head *head = htab->htable;
+	struct internal_slot *s, *os;
+	struct internal_chunk *chunk;
+	size_t hashval;
+
+	hashval = (*__default_hash)(item.key, strlen(item.key));
+
+	move_slots(head, MOVE_STEP);
+	s = probe(head->slots, head->size, hashval, item.key);
+	if (s->ent == NULL && head->old != NULL) {
+		os = probe(head->old, head->oldsize, hashval, item.key);
+		if (os->ent != NULL)
+			s = os;
 	}
 
-	if (ie != NULL)
+	if (s->ent != NULL)
           {
-            *retval = &ie->ent;
+            *retval = s->ent;
             return 1;
           }
 	else if (action == FIND)
@@ -179,16 +259,34 @@ hsearch_r(ENTRY item, ACTION action, ENTRY **retval, struct hsearch_data *htab)
             return 0;
           }
 
-	ie = malloc(sizeof *ie);
-	if (ie == NULL)
-          {
-            *retval = NULL;
-            return 0;
-          }
-	ie->ent.key = item.key;
-	ie->ent.data = item.data;
+	/* Grow past three quarters full; a full table is an error. */
+	if (head->old == NULL && head->count >= head->size / 4 * 3
+	    && grow(head)) {
+		htab->htablesize = head->size;
+		s = probe(head->slots, head->size, hashval, item.key);
+	} else if (head->count + 1 >= head->size) {
+		errno = ENOMEM;
+		*retval = NULL;
+		return 0;
+	}
+
+	if (head->avail == 0) {
+		chunk = malloc(sizeof *chunk);
+		if (chunk == NULL)
+		  {
+		    *retval = NULL;
+		    return 0;
+		  }
+		chunk->next = head->chunks;
+		head->chunks = chunk;
+		head->avail = ENTRIES_PER_CHUNK;
+	}
+	s->ent = &head->chunks->ent[--head->avail];
+	s->hash = hashval;
+	s->ent->key = item.key;
+	s->ent->data = item.data;
+	head->count++;
 
-	SLIST_INSERT_HEAD(head, ie, link);
-        *retval = &ie->ent;
+        *retval = s->ent;
 	return 1;
 }
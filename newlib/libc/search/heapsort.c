@@ -0,0 +1,64 @@
+/*
+FUNCTION
+<<heapsort>>---sort an array in guaranteed O(n log n) time
+
+INDEX
+	heapsort
+
+SYNOPSIS
+	#include <stdlib.h>
+	int heapsort(void *<[base]>, size_t <[nmemb]>, size_t <[size]>,
+		     int (*<[compar]>)(const void *, const void *));
+
+DESCRIPTION
+<<heapsort>> sorts an array in place, with the same arguments as
+<<qsort>>.  It is usually slower than <<qsort>>, but its running time
+is O(<[nmemb]> log <[nmemb]>) whatever the input, and it needs no
+memory besides the array.  Like <<qsort>>, it is not stable.
+
+RETURNS
+<<heapsort>> returns 0 on success.  If <[size]> is zero it returns -1
+and sets <<errno>> to <<EINVAL>>.
+
+PORTABILITY
+<<heapsort>> is a BSD extension.
+*/
+
+#include <_ansi.h>
+#include <errno.h>
+#include <stdlib.h>
+
+typedef int		 cmp_t(const void *, const void *);
+#define	CMP(t, x, y)	(cmp((x), (y)))
+#define	NEED_SIFTDOWN
+#include "sort_local.h"
+
+int
+heapsort (void *base,
+	size_t n,
+	size_t es,
+	int (*cmp)(const void *, const void *))
+{
+	char *a = base, *end;
+	size_t i;
+	int swaptype;
+
+	if (es == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (n <= 1)
+		return 0;
+	SWAPINIT(a, es);
+
+	/* Build a heap with the largest element at the front... */
+	for (i = n / 2; i-- > 0; )
+		siftdown(a, i, n, es, cmp, NULL, swaptype);
+
+	/* ...then repeatedly move it to the end and restore the heap. */
+	for (end = a + (n - 1) * es; --n > 0; end -= es) {
+		swap(a, end);
+		siftdown(a, 0, n, es, cmp, NULL, swaptype);
+	}
+	return 0;
+}
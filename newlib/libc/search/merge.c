@@ -0,0 +1,144 @@
+/*
+FUNCTION
+<<mergesort>>---stable sort of an array
+
+INDEX
+	mergesort
+
+SYNOPSIS
+	#include <stdlib.h>
+	int mergesort(void *<[base]>, size_t <[nmemb]>, size_t <[size]>,
+		      int (*<[compar]>)(const void *, const void *));
+
+DESCRIPTION
+<<mergesort>> sorts an array with the same arguments as <<qsort>>, but
+the sort is stable: elements that compare equal keep their original
+order, so records can be sorted on several keys by sorting on each key
+in turn, least significant first.  Its running time is O(<[nmemb]> log
+<[nmemb]>) whatever the input, and already ordered runs in the input
+are merged without comparing their elements one by one.
+
+<<mergesort>> needs a buffer as large as the array, which it obtains
+with <<malloc>>.
+
+RETURNS
+<<mergesort>> returns 0 on success.  It returns -1 and sets <<errno>>
+to <<EINVAL>> if <[size]> is zero, or to <<ENOMEM>> if the buffer cannot
+be allocated; the array is left unchanged in that case.
+
+PORTABILITY
+<<mergesort>> is a BSD extension.
+*/
+
+#include <_ansi.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sort_local.h"
+
+#define	CMP(x, y)	(cmp((x), (y)))
+
+/* Runs this long are insertion sorted before merging starts. */
+#define	RUN	8
+
+#define copy(d, s)					\
+	if (swaptype == 0)				\
+		*(long *)(d) = *(long *)(s);		\
+	else if (swaptype == 3)				\
+		*(uint16_t *)(d) = *(uint16_t *)(s);	\
+	else if (swaptype == 4)				\
+		*(uint32_t *)(d) = *(uint32_t *)(s);	\
+	else if (swaptype == 5)				\
+		*(uint64_t *)(d) = *(uint64_t *)(s);	\
+	else						\
+		memcpy(d, s, es)
+
+/*
+ * Merge the NL elements at L with the NR elements that follow them into
+ * OUT.  On ties the element from the left run comes first, which is what
+ * makes the sort stable.
+ */
+static void
+merge (char *l,
+	size_t nl,
+	size_t nr,
+	char *out,
+	size_t es,
+	int (*cmp)(const void *, const void *),
+	int swaptype)
+{
+	char *r = l + nl * es;
+	char *le = r, *re = r + nr * es;
+
+	/* Runs that are already in order are copied as they are. */
+	if (nr == 0 || CMP(r - es, r) <= 0) {
+		memcpy(out, l, (nl + nr) * es);
+		return;
+	}
+	while (l < le && r < re) {
+		if (CMP(r, l) < 0) {
+			copy(out, r);
+			r += es;
+		} else {
+			copy(out, l);
+			l += es;
+		}
+		out += es;
+	}
+	if (l < le)
+		memcpy(out, l, le - l);
+	else
+		memcpy(out, r, re - r);
+}
+
+int
+mergesort (void *base,
+	size_t n,
+	size_t es,
+	int (*cmp)(const void *, const void *))
+{
+	char *a = base, *buf, *src, *dst, *t, *pm, *pl;
+	size_t lo, mid, hi, w;
+	int swaptype;
+
+	if (es == 0) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (n <= 1)
+		return 0;
+	if (n > SIZE_MAX / es || (buf = malloc(n * es)) == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+	SWAPINIT(a, es);
+
+	/* Insertion sort short runs; only strictly greater elements move. */
+	for (lo = 0; lo < n; lo += RUN) {
+		hi = n - lo > RUN ? lo + RUN : n;
+		for (pm = a + (lo + 1) * es; pm < a + hi * es; pm += es)
+			for (pl = pm; pl > a + lo * es && CMP(pl - es, pl) > 0;
+			     pl -= es)
+				swap(pl, pl - es);
+	}
+
+	/* Merge pairs of runs, bouncing between the array and the buffer. */
+	src = a;
+	dst = buf;
+	for (w = RUN; w < n; w = w > n / 2 ? n : 2 * w) {
+		for (lo = 0; lo < n; lo = hi) {
+			mid = n - lo > w ? lo + w : n;
+			hi = n - mid > w ? mid + w : n;
+			merge(src + lo * es, mid - lo, hi - mid, dst + lo * es,
+			    es, cmp, swaptype);
+		}
+		t = src;
+		src = dst;
+		dst = t;
+	}
+	if (src != a)
+		memcpy(a, src, n * es);
+	free(buf);
+	return 0;
+}
@@ -62,9 +62,21 @@ __FBSDID("$FreeBSD$ : src/lib/libc/db/hash/ndbm.c Nov 20 19:49:47 2017 UTC by pf
  */
 extern DBM *
 dbm_open(const char *file, int flags, mode_t mode)
+{
+	return (dbm_open_hints(file, flags, mode, NULL));
+}
+
+/*
+ * As dbm_open, but with the buffer pool size, the page size of a new
+ * database and the overflow read-ahead taken from hints if not zero.
+ */
+extern DBM *
+dbm_open_hints(const char *file, int flags, mode_t mode,
+    const struct dbm_hints *hints)
 {
 	HASHINFO info;
 	char path[MAXPATHLEN];
+	DBM *db;
 
 	info.bsize = 4096;
 	info.ffactor = 40;
@@ -72,6 +84,11 @@ dbm_open(const char *file, int flags, mode_t mode)
 	info.cachesize = 0;
 	info.hash = NULL;
 	info.lorder = 0;
+	if (hints) {
+		if (hints->bsize)
+			info.bsize = hints->bsize;
+		info.cachesize = hints->cachesize;
+	}
 
 	if( strlen(file) >= sizeof(path) - strlen(DBM_SUFFIX)) {
 		errno = ENAMETOOLONG;
@@ -79,7 +96,10 @@ dbm_open(const char *file, int flags, mode_t mode)
 	}
 	(void)strcpy(path, file);
 	(void)strcat(path, DBM_SUFFIX);
-	return ((DBM *)__hash_open(path, flags, mode, 0, &info));
+	db = (DBM *)__hash_open(path, flags, mode, 0, &info);
+	if (db && hints)
+		((HTAB *)db->internal)->readahead = hints->readahead;
+	return (db);
 }
 
 extern void
@@ -215,3 +235,16 @@ dbm_dirfno(DBM *db)
 {
 	return(((HTAB *)db->internal)->fp);
 }
+
+extern int
+dbm_getstats(DBM *db, struct dbm_stats *st)
+{
+	HTAB *hp;
+
+	hp = (HTAB *)db->internal;
+	st->hits = hp->nhits;
+	st->misses = hp->nmisses;
+	st->readahead = hp->nreadahead;
+	st->splits = hp->nsplits;
+	return (0);
+}
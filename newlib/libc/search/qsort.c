@@ -72,79 +72,95 @@ PORTABILITY
 
 #if defined(I_AM_QSORT_R)
 typedef int		 cmp_t(void *, const void *, const void *);
-#elif defined(I_AM_GNU_QSORT_R)
+#elif defined(I_AM_GNU_QSORT_R) || defined(I_AM_PREFIX_QSORT_R)
 typedef int		 cmp_t(const void *, const void *, void *);
 #else
 typedef int		 cmp_t(const void *, const void *);
 #endif
 static inline char	*med3 (char *, char *, char *, cmp_t *, void *);
-static inline void	 swapfunc (char *, char *, int, int);
 
 #define min(a, b)	(a) < (b) ? a : b
 
 /*
  * Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * The element swapping helpers live in sort_local.h.
  */
-#define swapcode(TYPE, parmi, parmj, n) { 		\
-	long i = (n) / sizeof (TYPE); 			\
-	TYPE *pi = (TYPE *) (parmi); 		\
-	TYPE *pj = (TYPE *) (parmj); 		\
-	do { 						\
-		TYPE	t = *pi;		\
-		*pi++ = *pj;				\
-		*pj++ = t;				\
-        } while (--i > 0);				\
-}
-
-#define SWAPINIT(a, es) swaptype = ((char *)a - (char *)0) % sizeof(long) || \
-	es % sizeof(long) ? 2 : es == sizeof(long)? 0 : 1;
-
-static inline void
-swapfunc (char *a,
-	char *b,
-	int n,
-	int swaptype)
-{
-	if(swaptype <= 1)
-		swapcode(long, a, b, n)
-	else
-		swapcode(char, a, b, n)
-}
-
-#define swap(a, b)					\
-	if (swaptype == 0) {				\
-		long t = *(long *)(a);			\
-		*(long *)(a) = *(long *)(b);		\
-		*(long *)(b) = t;			\
-	} else						\
-		swapfunc(a, b, es, swaptype)
-
-#define vecswap(a, b, n) 	if ((n) > 0) swapfunc(a, b, n, swaptype)
-
 #if defined(I_AM_QSORT_R)
 #define	CMP(t, x, y) (cmp((t), (x), (y)))
 #elif defined(I_AM_GNU_QSORT_R)
 #define	CMP(t, x, y) (cmp((x), (y), (t)))
+#elif defined(I_AM_PREFIX_QSORT_R)
+#define	CMP(t, x, y) (prefix_cmp((x), (y), cmp, (t)))
+
+/*
+ * Order two elements by the unsigned long key at their start, and only
+ * consult the comparison function, if any, when the keys are equal.
+ */
+static inline int
+prefix_cmp (const void *x,
+	const void *y,
+	cmp_t *cmp,
+	void *thunk)
+{
+	unsigned long kx = *(const unsigned long *) x;
+	unsigned long ky = *(const unsigned long *) y;
+
+	if (kx != ky)
+		return kx < ky ? -1 : 1;
+	return cmp != NULL ? cmp(x, y, thunk) : 0;
+}
 #else
 #define	CMP(t, x, y) (cmp((x), (y)))
 #endif
 
+#if !defined(I_AM_QSORT_R) && !defined(I_AM_GNU_QSORT_R) \
+    && !defined(I_AM_PREFIX_QSORT_R)
+#define THUNK_UNUSED __unused
+#else
+#define THUNK_UNUSED
+#endif
+
+#define NEED_SIFTDOWN
+#include "sort_local.h"
+
 static inline char *
 med3 (char *a,
 	char *b,
 	char *c,
 	cmp_t *cmp,
-	void *thunk
-#if !defined(I_AM_QSORT_R) && !defined(I_AM_GNU_QSORT_R)
-__unused
-#endif
-)
+	void *thunk THUNK_UNUSED)
 {
 	return CMP(thunk, a, b) < 0 ?
 	       (CMP(thunk, b, c) < 0 ? b : (CMP(thunk, a, c) < 0 ? c : a ))
               :(CMP(thunk, b, c) > 0 ? b : (CMP(thunk, a, c) < 0 ? a : c ));
 }
 
+/*
+ * Heapsort, for partitions that quicksort keeps splitting badly.  It is
+ * slower on average but cannot go quadratic.
+ */
+static void
+heapsort_part (char *a,
+	size_t n,
+	size_t es,
+	cmp_t *cmp,
+	void *thunk THUNK_UNUSED,
+	int swaptype)
+{
+	char *end;
+	size_t i;
+
+	/* Build a heap with the largest element at the front... */
+	for (i = n / 2; i-- > 0; )
+		siftdown(a, i, n, es, cmp, thunk, swaptype);
+
+	/* ...then repeatedly move it to the end and restore the heap. */
+	for (end = a + (n - 1) * es; --n > 0; end -= es) {
+		swap(a, end);
+		siftdown(a, 0, n, es, cmp, thunk, swaptype);
+	}
+}
+
 /*
  * Classical function call recursion wastes a lot of stack space. Each
  * recursion level requires a full stack frame comprising all local variables
@@ -158,55 +174,52 @@ __unused
  * the parameter stack array is chosen to be similar to the stack frame
  * excluding the array. Each function call recursion level can handle this
  * number of iterative recursion levels.
+ *
+ * Each partition also counts against a depth budget of 2 * log2(n) levels.
+ * Once a part has used that up, it is sorted with heapsort instead, so
+ * that no input can make the sort quadratic (Musser's introsort).
  */
 #define PARAMETER_STACK_LEVELS 8u
 
-#if defined(I_AM_QSORT_R)
-void
-__bsd_qsort_r (void *a,
-	size_t n,
-	size_t es,
-	void *thunk,
-	cmp_t *cmp)
-#elif defined(I_AM_GNU_QSORT_R)
-void
-qsort_r (void *a,
+static void
+introsort (char *a,
 	size_t n,
 	size_t es,
 	cmp_t *cmp,
-	void *thunk)
-#else
-#define thunk NULL
-void
-qsort (void *a,
-	size_t n,
-	size_t es,
-	cmp_t *cmp)
-#endif
+	void *thunk THUNK_UNUSED,
+	int swaptype,
+	size_t depth)
 {
 	char *pa, *pb, *pc, *pd, *pl, *pm, *pn;
 	size_t d, r;
 	int cmp_result;
-	int swaptype, swap_cnt;
+	size_t swap_cnt;
 	size_t recursion_level = 0;
-	struct { void *a; size_t n; } parameter_stack[PARAMETER_STACK_LEVELS];
+	struct { char *a; size_t n; size_t depth; }
+		parameter_stack[PARAMETER_STACK_LEVELS];
 
-	SWAPINIT(a, es);
 loop:	swap_cnt = 0;
 	if (n < 7) {
 		/* Short arrays are insertion sorted. */
-		for (pm = (char *) a + es; pm < (char *) a + n * es; pm += es)
-			for (pl = pm; pl > (char *) a && CMP(thunk, pl - es, pl) > 0;
+		for (pm = a + es; pm < a + n * es; pm += es)
+			for (pl = pm; pl > a && CMP(thunk, pl - es, pl) > 0;
 			     pl -= es)
 				swap(pl, pl - es);
 		goto pop;
 	}
 
+	/* Too many bad partitions already: fall back to heapsort. */
+	if (depth == 0) {
+		heapsort_part(a, n, es, cmp, thunk, swaptype);
+		goto pop;
+	}
+	depth--;
+
 	/* Select a pivot element, move it to the left. */
-	pm = (char *) a + (n / 2) * es;
+	pm = a + (n / 2) * es;
 	if (n > 7) {
 		pl = a;
-		pn = (char *) a + (n - 1) * es;
+		pn = a + (n - 1) * es;
 		if (n > 40) {
 			d = (n / 8) * es;
 			pl = med3(pl, pl + d, pl + 2 * d, cmp, thunk);
@@ -221,8 +234,8 @@ loop:	swap_cnt = 0;
 	 * Sort the array relative the pivot in four ranges as follows:
 	 * { elems == pivot, elems < pivot, elems > pivot, elems == pivot }
 	 */
-	pa = pb = (char *) a + es;
-	pc = pd = (char *) a + (n - 1) * es;
+	pa = pb = a + es;
+	pc = pd = a + (n - 1) * es;
 	for (;;) {
 		/* Scan left to right stopping at first element > pivot. */
 		while (pb <= pc && (cmp_result = CMP(thunk, pb, a)) <= 0) {
@@ -253,10 +266,22 @@ loop:	swap_cnt = 0;
 		pc -= es;
 	}
 	if (swap_cnt == 0) {  /* Switch to insertion sort */
-		for (pm = (char *) a + es; pm < (char *) a + n * es; pm += es)
-			for (pl = pm; pl > (char *) a && CMP(thunk, pl - es, pl) > 0;
-			     pl -= es)
+		/*
+		 * The array looked sorted, but it may only be partitioned.
+		 * Give up after 2 * n moves and partition it again rather
+		 * than let insertion sort go quadratic; the depth budget
+		 * bounds how often that can happen.  Sorted, reversed and
+		 * nearly sorted runs need fewer moves than that, so they
+		 * are still done in one linear pass.
+		 */
+		r = n <= SIZE_MAX / 2 ? 2 * n : SIZE_MAX;
+		for (pm = a + es; pm < a + n * es; pm += es)
+			for (pl = pm; pl > a && CMP(thunk, pl - es, pl) > 0;
+			     pl -= es) {
 				swap(pl, pl - es);
+				if (++swap_cnt > r)
+					goto loop;
+			}
 		goto pop;
 	}
 
@@ -264,8 +289,8 @@ loop:	swap_cnt = 0;
 	 * Rearrange the array in three parts sorted like this:
 	 * { elements < pivot, elements == pivot, elements > pivot }
 	 */
-	pn = (char *) a + n * es;
-	r = min(pa - (char *)a, pb - pa);
+	pn = a + n * es;
+	r = min(pa - a, pb - pa);
 	vecswap(a, pb - r, r);
 	r = min(pd - pc, pn - pd - es);
 	vecswap(pb, pn - r, r);
@@ -310,6 +335,7 @@ loop:	swap_cnt = 0;
 			 */
 			parameter_stack[recursion_level].a = a;
 			parameter_stack[recursion_level].n = n / es;
+			parameter_stack[recursion_level].depth = depth;
 			recursion_level++;
 			a = pa;
 			n = r / es;
@@ -321,13 +347,7 @@ loop:	swap_cnt = 0;
 			 * is sorted using function call recursion. The larger
 			 * part will be sorted after the function call returns.
 			 */
-#if defined(I_AM_QSORT_R)
-			__bsd_qsort_r(pa, r / es, es, thunk, cmp);
-#elif defined(I_AM_GNU_QSORT_R)
-			qsort_r(pa, r / es, es, cmp, thunk);
-#else
-			qsort(pa, r / es, es, cmp);
-#endif
+			introsort(pa, r / es, es, cmp, thunk, swaptype, depth);
 		}
 	}
 	if (n > es) {  /* The larger part needs sorting. Iterate to sort.  */
@@ -340,6 +360,46 @@ pop:
 		recursion_level--;
 		a = parameter_stack[recursion_level].a;
 		n = parameter_stack[recursion_level].n;
+		depth = parameter_stack[recursion_level].depth;
 		goto loop;
 	}
 }
+
+#if defined(I_AM_QSORT_R)
+void
+__bsd_qsort_r (void *a,
+	size_t n,
+	size_t es,
+	void *thunk,
+	cmp_t *cmp)
+#elif defined(I_AM_GNU_QSORT_R)
+void
+qsort_r (void *a,
+	size_t n,
+	size_t es,
+	cmp_t *cmp,
+	void *thunk)
+#elif defined(I_AM_PREFIX_QSORT_R)
+void
+qsort_prefix_r (void *a,
+	size_t n,
+	size_t es,
+	cmp_t *cmp,
+	void *thunk)
+#else
+#define thunk NULL
+void
+qsort (void *a,
+	size_t n,
+	size_t es,
+	cmp_t *cmp)
+#endif
+{
+	int swaptype;
+	size_t depth, m;
+
+	SWAPINIT(a, es);
+	for (depth = 0, m = n; m > 1; m >>= 1)
+		depth += 2;
+	introsort(a, n, es, cmp, thunk, swaptype, depth);
+}
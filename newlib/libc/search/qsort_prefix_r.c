@@ -0,0 +1,36 @@
+/*
+FUNCTION
+<<qsort_prefix_r>>---sort an array on an inline key prefix
+
+INDEX
+	qsort_prefix_r
+
+SYNOPSIS
+	#include <stdlib.h>
+	void qsort_prefix_r(void *<[base]>, size_t <[nmemb]>, size_t <[size]>,
+			    int (*<[compar]>)(const void *, const void *, void *),
+			    void *<[thunk]>);
+
+DESCRIPTION
+<<qsort_prefix_r>> sorts an array (beginning at <[base]>) of <[nmemb]>
+objects of <[size]> bytes each, like the GNU form of <<qsort_r>>, but
+every object must begin with an <<unsigned long>> key, and <[base]> must
+be suitably aligned for it.  Objects are ordered by that key first, with
+no function call, and <<(*<[compar]>)>> is only called, with <[thunk]> as
+its third argument, to order objects whose keys are equal.  <[compar]>
+may be NULL if equal keys need no further ordering.
+
+A typical use is to sort an array of pointers to records: each element
+pairs a pointer with a key prefix computed once from the record (for
+example, the leading bytes of a string name, most significant first),
+so that most comparisons never follow the pointer.
+
+RETURNS
+<<qsort_prefix_r>> does not return a result.
+
+PORTABILITY
+<<qsort_prefix_r>> is a newlib extension.
+*/
+
+#define I_AM_PREFIX_QSORT_R
+#include "qsort.c"
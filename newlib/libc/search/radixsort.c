@@ -0,0 +1,276 @@
+/*
+FUNCTION
+<<radixsort>>, <<sradixsort>>---sort an array of byte strings
+
+INDEX
+	radixsort
+INDEX
+	sradixsort
+
+SYNOPSIS
+	#include <stdlib.h>
+	int radixsort(const unsigned char **<[base]>, int <[nmemb]>,
+		      const unsigned char *<[table]>, unsigned <[endbyte]>);
+	int sradixsort(const unsigned char **<[base]>, int <[nmemb]>,
+		       const unsigned char *<[table]>, unsigned <[endbyte]>);
+
+DESCRIPTION
+<<radixsort>> and <<sradixsort>> sort an array of <[nmemb]> pointers to
+byte strings, beginning at <[base]>, by rearranging the pointers.  They
+look at the bytes of the strings directly and never call a comparison
+function, which makes them much faster than <<qsort>> for string keys.
+
+If <[table]> is NULL, strings are ordered by the unsigned values of
+their bytes and end with the byte <[endbyte]>, usually <<'\0'>>, which
+sorts before every other byte.  Otherwise <[table]> is an array of 256
+sort weights indexed by byte value: bytes with equal weights sort as
+equal, and a string ends at the first byte whose weight is that of
+<[endbyte]>, which must be 0 (shorter strings first) or 255 (shorter
+strings last).
+
+<<radixsort>> needs no memory besides the array and a little stack,
+but strings that sort as equal may come out in any order.
+<<sradixsort>> is stable and uses a temporary array of <[nmemb]>
+pointers, obtained with <<malloc>>.
+
+RETURNS
+Both functions return 0 on success.  They return -1 and set <<errno>>
+to <<EINVAL>> if the weight of <[endbyte]> in <[table]> is neither 0
+nor 255, and <<sradixsort>> sets it to <<ENOMEM>> if it cannot
+allocate its temporary array.
+
+PORTABILITY
+<<radixsort>> and <<sradixsort>> are BSD extensions.
+*/
+
+#include <_ansi.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * This is a most significant byte first radix sort.  Each pass counts
+ * the strings in a range by their byte at the current depth and
+ * distributes them into contiguous buckets, either in place with the
+ * "American flag" permutation of McIlroy, Bostic and McIlroy, or stably
+ * through a temporary array.  The biggest bucket is then sorted by
+ * iterating and the others by recursion, so that the recursion is at
+ * most log2(n) deep however long the strings are.  Short ranges are
+ * insertion sorted.
+ */
+
+typedef const unsigned char *string;
+
+/* Ranges shorter than this are insertion sorted. */
+#define	THRESHOLD	16
+
+struct rsort_state {
+	const unsigned char *tr;	/* byte weights */
+	unsigned char endch;		/* weight that ends a string */
+	string *ta;			/* temporary array, or NULL */
+	int count[256];
+	string *pile[256];
+};
+
+/* Compare two strings from byte DEPTH on, by weight. */
+static int
+compare (string s,
+	string t,
+	size_t depth,
+	const struct rsort_state *st)
+{
+	const unsigned char *tr = st->tr;
+	int cs, ct;
+
+	for (;; depth++) {
+		cs = tr[s[depth]];
+		ct = tr[t[depth]];
+		if (cs != ct)
+			return cs - ct;
+		if (cs == st->endch)
+			return 0;
+	}
+}
+
+/* Stable insertion sort of the N strings at A from byte DEPTH on. */
+static void
+simplesort (string *a,
+	int n,
+	size_t depth,
+	const struct rsort_state *st)
+{
+	string *ai, *aj, s;
+
+	for (ai = a + 1; ai < a + n; ai++) {
+		s = *ai;
+		for (aj = ai; aj > a && compare(aj[-1], s, depth, st) > 0; aj--)
+			*aj = aj[-1];
+		*aj = s;
+	}
+}
+
+static void
+rsort (string *a,
+	int n,
+	size_t depth,
+	struct rsort_state *st)
+{
+	const unsigned char *tr = st->tr;
+	int *count = st->count;
+	string **pile = st->pile;
+	string *ak, *an, *big, r, t;
+	int c, bigc, nbig;
+
+	for (;;) {
+		if (n < THRESHOLD) {
+			simplesort(a, n, depth, st);
+			return;
+		}
+		an = a + n;
+
+		/* Count the strings by the weight of byte DEPTH. */
+		memset(count, 0, sizeof st->count);
+		for (ak = a; ak < an; ak++)
+			count[tr[(*ak)[depth]]]++;
+
+		/* All in one bucket: nothing to move, look further on. */
+		c = tr[a[0][depth]];
+		if (count[c] == n) {
+			if (c == st->endch)
+				return;
+			depth++;
+			continue;
+		}
+
+		/* Find where each bucket ends. */
+		for (ak = a, c = 0; c < 256; c++) {
+			ak += count[c];
+			pile[c] = ak;
+		}
+
+		if (st->ta != NULL) {
+			/* Stable: copy out, then deal back from the end. */
+			memcpy(st->ta, a, n * sizeof *a);
+			for (ak = st->ta + n; ak-- > st->ta; )
+				*--pile[tr[(*ak)[depth]]] = *ak;
+		} else {
+			/*
+			 * In place: carry each string to the top of its
+			 * bucket, picking up the one that was there, until
+			 * a string for the current slot turns up.
+			 */
+			for (ak = a; ak < an; ) {
+				r = *ak;
+				while (--pile[c = tr[r[depth]]] > ak) {
+					t = *pile[c];
+					*pile[c] = r;
+					r = t;
+				}
+				*ak = r;
+				ak += count[c];
+				count[c] = 0;
+			}
+		}
+
+		/*
+		 * The buckets are now contiguous runs of equal weight.
+		 * Find the biggest one that still needs sorting, and
+		 * recurse on the others.
+		 */
+		big = NULL;
+		nbig = 1;
+		for (ak = a; ak < an; ak += c) {
+			bigc = tr[(*ak)[depth]];
+			for (c = 1; ak + c < an && tr[ak[c][depth]] == bigc; c++)
+				continue;
+			if (bigc != st->endch && c > nbig) {
+				big = ak;
+				nbig = c;
+			}
+		}
+		for (ak = a; ak < an; ak += c) {
+			bigc = tr[(*ak)[depth]];
+			for (c = 1; ak + c < an && tr[ak[c][depth]] == bigc; c++)
+				continue;
+			if (bigc != st->endch && c > 1 && ak != big)
+				rsort(ak, c, depth + 1, st);
+		}
+		if (big == NULL)
+			return;
+		a = big;
+		n = nbig;
+		depth++;
+	}
+}
+
+static int
+radix_setup (const unsigned char *table,
+	unsigned endbyte,
+	unsigned char *tr0,
+	struct rsort_state *st)
+{
+	unsigned c;
+
+	if (table == NULL) {
+		/* Byte values, with the end byte moved below the rest. */
+		endbyte &= 0xff;
+		for (c = 0; c < endbyte; c++)
+			tr0[c] = c + 1;
+		tr0[c] = 0;
+		for (c++; c < 256; c++)
+			tr0[c] = c;
+		st->tr = tr0;
+		st->endch = 0;
+	} else {
+		st->tr = table;
+		st->endch = table[endbyte & 0xff];
+		if (st->endch != 0 && st->endch != 255) {
+			errno = EINVAL;
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int
+radixsort (const unsigned char **a,
+	int n,
+	const unsigned char *table,
+	unsigned endbyte)
+{
+	unsigned char tr0[256];
+	struct rsort_state st;
+
+	if (radix_setup(table, endbyte, tr0, &st) < 0)
+		return -1;
+	st.ta = NULL;
+	if (n > 1)
+		rsort(a, n, 0, &st);
+	return 0;
+}
+
+int
+sradixsort (const unsigned char **a,
+	int n,
+	const unsigned char *table,
+	unsigned endbyte)
+{
+	unsigned char tr0[256];
+	struct rsort_state st;
+
+	if (radix_setup(table, endbyte, tr0, &st) < 0)
+		return -1;
+	if (n < THRESHOLD) {
+		if (n > 1)
+			simplesort(a, n, 0, &st);
+		return 0;
+	}
+	st.ta = malloc(n * sizeof *st.ta);
+	if (st.ta == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+	rsort(a, n, 0, &st);
+	free(st.ta);
+	return 0;
+}
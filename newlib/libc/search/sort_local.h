@@ -0,0 +1,155 @@
+/*-
+ * Copyright (c) 1992, 1993
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the University nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * Element swapping helpers from Bentley & McIlroy's "Engineering a Sort
+ * Function", shared by qsort, heapsort and mergesort.  swap() and
+ * vecswap() expect the element size in `es' and the result of SWAPINIT
+ * in `swaptype'.
+ *
+ * A file that defines NEED_SIFTDOWN, cmp_t and CMP(thunk, x, y) before
+ * including this one also gets siftdown(), for heapsort.
+ */
+
+#ifndef _SORT_LOCAL_H_
+#define _SORT_LOCAL_H_
+
+#include <sys/cdefs.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef __GNUC__
+#define inline
+#endif
+
+#define swapcode(TYPE, parmi, parmj, n) { 		\
+	long i = (n) / sizeof (TYPE); 			\
+	TYPE *pi = (TYPE *) (parmi); 		\
+	TYPE *pj = (TYPE *) (parmj); 		\
+	do { 						\
+		TYPE	t = *pi;		\
+		*pi++ = *pj;				\
+		*pj++ = t;				\
+        } while (--i > 0);				\
+}
+
+#define swapword(TYPE, a, b) {				\
+	TYPE t = *(TYPE *)(a);				\
+	*(TYPE *)(a) = *(TYPE *)(b);			\
+	*(TYPE *)(b) = t;				\
+}
+
+#define ALIGNED(a, TYPE) (((char *)(a) - (char *)0) % sizeof(TYPE) == 0)
+
+/*
+ * swaptype is 0 if each element is one long, 1 if it is several longs
+ * and 2 if it has to be moved byte by byte.  3, 4 and 5 are for elements
+ * that are a single aligned 16-, 32- or 64-bit word other than a long;
+ * on 16-bit targets this is what an array of ints gets.
+ */
+static inline int
+swapinit (char *a,
+	size_t es)
+{
+	if (es == sizeof(long) && ALIGNED(a, long))
+		return 0;
+	if (es == 2 && ALIGNED(a, uint16_t))
+		return 3;
+	if (es == 4 && ALIGNED(a, uint32_t))
+		return 4;
+	if (es == 8 && ALIGNED(a, uint64_t))
+		return 5;
+	return ALIGNED(a, long) && es % sizeof(long) == 0 ? 1 : 2;
+}
+
+#define SWAPINIT(a, es) swaptype = swapinit((char *)(a), (es))
+
+static inline void
+swapfunc (char *a,
+	char *b,
+	size_t n,
+	int swaptype)
+{
+	if (swaptype <= 1)
+		swapcode(long, a, b, n)
+	else if (swaptype == 3)
+		swapcode(uint16_t, a, b, n)
+	else if (swaptype == 4)
+		swapcode(uint32_t, a, b, n)
+	else if (swaptype == 5)
+		swapcode(uint64_t, a, b, n)
+	else
+		swapcode(char, a, b, n)
+}
+
+#define swap(a, b)					\
+	if (swaptype == 0)				\
+		swapword(long, a, b)			\
+	else if (swaptype == 3)				\
+		swapword(uint16_t, a, b)		\
+	else if (swaptype == 4)				\
+		swapword(uint32_t, a, b)		\
+	else if (swaptype == 5)				\
+		swapword(uint64_t, a, b)		\
+	else						\
+		swapfunc(a, b, es, swaptype)
+
+#define vecswap(a, b, n) 	if ((n) > 0) swapfunc(a, b, n, swaptype)
+
+#ifdef NEED_SIFTDOWN
+/*
+ * Move the element at index K down the heap of N elements at A until
+ * neither child is larger.
+ */
+static void
+siftdown (char *a,
+	size_t k,
+	size_t n,
+	size_t es,
+	cmp_t *cmp,
+	void *thunk __unused,
+	int swaptype)
+{
+	char *root, *child;
+
+	while ((k = 2 * k + 1) < n) {
+		root = a + (k - 1) / 2 * es;
+		child = a + k * es;
+		if (k + 1 < n && CMP(thunk, child, child + es) < 0) {
+			child += es;
+			k++;
+		}
+		if (CMP(thunk, root, child) >= 0)
+			break;
+		swap(root, child);
+	}
+}
+#endif
+
+#endif /* !_SORT_LOCAL_H_ */
@@ -2,7 +2,8 @@
 
 /*
  * Tree search generalized from Knuth (6.2.2) Algorithm T just like
- * the AT&T man page says.
+ * the AT&T man page says.  After the node is unlinked, the tree is
+ * rebalanced on the way back up as described in Knuth (6.2.3).
  *
  * The node_t structure is for internal use only, lint doesn't grok it.
  *
@@ -30,37 +31,65 @@ tdelete (const void *__restrict vkey,	/* key to be deleted */
 	void      **__restrict vrootp,	/* address of the root of tree */
 	int       (*compar)(const void *, const void *))
 {
-	node_t **rootp = (node_t **)vrootp;
-	node_t *p, *q, *r;
-	int  cmp;
+	node_t **path[__TMAXDEPTH + 1];	/* links followed from the root */
+	node_t *parent, *p, *q, *r;
+	int  cmp, depth = 0, found;
 
-	if (rootp == NULL || (p = *rootp) == NULL)
+	if (vrootp == NULL || *vrootp == NULL)
 		return NULL;
 
-	while ((cmp = (*compar)(vkey, (*rootp)->key)) != 0) {
-		p = *rootp;
-		rootp = (cmp < 0) ?
-		    &(*rootp)->llink :		/* follow llink branch */
-		    &(*rootp)->rlink;		/* follow rlink branch */
-		if (*rootp == NULL)
+	path[0] = (node_t **)vrootp;
+	p = *path[0];
+	while ((cmp = (*compar)(vkey, p->key)) != 0) {
+		path[++depth] = __TLINK(p, cmp > 0);
+		if ((p = __TPTR(*path[depth])) == NULL)
 			return NULL;		/* key not found */
 	}
-	r = (*rootp)->rlink;			/* D1: */
-	if ((q = (*rootp)->llink) == NULL)	/* Left NULL? */
-		q = r;
-	else if (r != NULL) {			/* Right link is NULL? */
-		if (r->llink == NULL) {		/* D2: Find successor */
-			r->llink = q;
-			q = r;
-		} else {			/* D3: Find NULL link */
-			for (q = r->llink; q->llink != NULL; q = r->llink)
-				r = q;
-			r->llink = q->rlink;
-			q->llink = (*rootp)->llink;
-			q->rlink = (*rootp)->rlink;
+	/* The root has no parent; hand back something that is not freed. */
+	parent = depth ? __TPTR(*path[depth - 1]) : (node_t *)vrootp;
+	found = depth;
+
+	r = __TPTR(p->rlink);			/* D1: */
+	if ((q = __TPTR(p->llink)) == NULL)	/* Left NULL? */
+		__TSETLINK(path[depth], r);
+	else if (r == NULL)			/* Right link is NULL? */
+		__TSETLINK(path[depth], q);
+	else {
+		/* D2/D3: find the successor and unlink it from its place. */
+		path[++depth] = &p->rlink;
+		for (q = r; __TPTR(q->llink) != NULL; q = __TPTR(q->llink))
+			path[++depth] = &q->llink;
+		__TSETLINK(path[depth], __TPTR(q->rlink));
+
+		/* Then let it take over P's links and balance. */
+		q->llink = p->llink;
+		q->rlink = p->rlink;
+		__TSETLINK(path[found], q);
+		path[found + 1] = &q->rlink;
+	}
+	free(p);				/* D4: Free node */
+
+	/* Walk back up, adjusting balance while subtrees keep shrinking. */
+	while (--depth >= 0) {
+		int dir, heavy, shrunk;
+
+		p = __TPTR(*path[depth]);
+		dir = path[depth + 1] == &p->rlink;	/* the side that shrank */
+		heavy = dir ? 1 : -1;
+		switch (__TBALANCE(p) * heavy) {
+		case 1:
+			__TSETBAL(p, 0);
+			continue;
+		case 0:
+			__TSETBAL(p, -heavy);
+			break;
+		default:
+			__TSETLINK(path[depth], __trotate(p, !dir, &shrunk));
+			if (shrunk)
+				continue;
+			break;
 		}
+		break;
 	}
-	free(*rootp);				/* D4: Free node */
-	*rootp = q;				/* link parent to new node */
-	return p;
+	return parent;
 }
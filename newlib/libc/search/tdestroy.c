@@ -30,10 +30,12 @@ trecurse(root, free_action)
 	node_t *root;	/* Root of the tree to be walked */
 	void (*free_action)(void *);
 {
-  if (root->llink != NULL)
-    trecurse(root->llink, free_action);
-  if (root->rlink != NULL)
-    trecurse(root->rlink, free_action);
+  node_t *l = __TPTR(root->llink), *r = __TPTR(root->rlink);
+
+  if (l != NULL)
+    trecurse(l, free_action);
+  if (r != NULL)
+    trecurse(r, free_action);
 
   (*free_action) ((void *) root->key);
   free(root);
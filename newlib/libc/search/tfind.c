@@ -29,19 +29,20 @@ tfind (const void *vkey,		/* key to be found */
 	void **vrootp,		/* address of the tree root */
 	int (*compar)(const void *, const void *))
 {
-	node_t **rootp = (node_t **)vrootp;
+	node_t *p;
 
-	if (rootp == NULL)
+	if (vrootp == NULL)
 		return NULL;
 
-	while (*rootp != NULL) {		/* T1: */
+	p = *vrootp;
+	while (p != NULL) {			/* T1: */
 		int r;
 
-		if ((r = (*compar)(vkey, (*rootp)->key)) == 0)	/* T2: */
-			return *rootp;		/* key found */
-		rootp = (r < 0) ?
-		    &(*rootp)->llink :		/* T3: follow left branch */
-		    &(*rootp)->rlink;		/* T4: follow right branch */
+		if ((r = (*compar)(vkey, p->key)) == 0)	/* T2: */
+			return p;		/* key found */
+		p = __TPTR((r < 0) ?
+		    p->llink :			/* T3: follow left branch */
+		    p->rlink);			/* T4: follow right branch */
 	}
 	return NULL;
 }
@@ -2,7 +2,8 @@
 
 /*
  * Tree search generalized from Knuth (6.2.2) Algorithm T just like
- * the AT&T man page says.
+ * the AT&T man page says.  The tree is kept balanced as in Knuth (6.2.3)
+ * Algorithm A, so that keys arriving in order do not degrade it into a list.
  *
  * The node_t structure is for internal use only, lint doesn't grok it.
  *
@@ -23,35 +24,99 @@ __RCSID("$NetBSD: tsearch.c,v 1.3 1999/09/16 11:45:37 lukem Exp $");
 #include <search.h>
 #include <stdlib.h>
 
+/*
+ * Rebalance the subtree rooted at N after its DIR side (0 for left, 1 for
+ * right) has become two levels taller than the other side, and return the
+ * new root of the subtree.  *SHRUNKP is set if the subtree is now one level
+ * shorter than the taller side was, which is always so after an insertion.
+ */
+node_t *
+__trotate (node_t *n, int dir, int *shrunkp)
+{
+	int heavy = dir ? 1 : -1;
+	node_t *c = __TPTR(*__TLINK(n, dir));	/* the taller child */
+	node_t *g;
+	int b = __TBALANCE(c);
+
+	if (b != -heavy) {			/* single rotation */
+		__TSETLINK(__TLINK(n, dir), __TPTR(*__TLINK(c, !dir)));
+		__TSETLINK(__TLINK(c, !dir), n);
+		if (b == 0) {			/* only after a deletion */
+			__TSETBAL(c, -heavy);
+			__TSETBAL(n, heavy);
+			*shrunkp = 0;
+		} else {
+			__TSETBAL(c, 0);
+			__TSETBAL(n, 0);
+			*shrunkp = 1;
+		}
+		return c;
+	}
+
+	g = __TPTR(*__TLINK(c, !dir));		/* double rotation */
+	b = __TBALANCE(g);
+	__TSETLINK(__TLINK(c, !dir), __TPTR(*__TLINK(g, dir)));
+	__TSETLINK(__TLINK(n, dir), __TPTR(*__TLINK(g, !dir)));
+	__TSETLINK(__TLINK(g, dir), c);
+	__TSETLINK(__TLINK(g, !dir), n);
+	__TSETBAL(c, b == -heavy ? heavy : 0);
+	__TSETBAL(n, b == heavy ? -heavy : 0);
+	__TSETBAL(g, 0);
+	*shrunkp = 1;
+	return g;
+}
+
 /* find or insert datum into search tree */
 void *
 tsearch (const void *vkey,		/* key to be located */
 	void **vrootp,		/* address of tree root */
 	int (*compar)(const void *, const void *))
 {
-	node_t *q;
-	node_t **rootp = (node_t **)vrootp;
+	node_t **path[__TMAXDEPTH + 1];	/* links followed from the root */
+	node_t *p, *q;
+	int depth = 0;
 
-	if (rootp == NULL)
+	if (vrootp == NULL)
 		return NULL;
 
-	while (*rootp != NULL) {	/* Knuth's T1: */
+	path[0] = (node_t **)vrootp;
+	while ((p = __TPTR(*path[depth])) != NULL) {	/* Knuth's T1: */
 		int r;
 
-		if ((r = (*compar)(vkey, (*rootp)->key)) == 0)	/* T2: */
-			return *rootp;		/* we found it! */
+		if ((r = (*compar)(vkey, p->key)) == 0)	/* T2: */
+			return p;		/* we found it! */
 
-		rootp = (r < 0) ?
-		    &(*rootp)->llink :		/* T3: follow left branch */
-		    &(*rootp)->rlink;		/* T4: follow right branch */
+		/* T3/T4: follow left or right branch */
+		path[++depth] = __TLINK(p, r > 0);
 	}
 
 	q = malloc(sizeof(node_t));		/* T5: key not found */
-	if (q != 0) {				/* make new node */
-		*rootp = q;			/* link new node to old */
-		/* LINTED const castaway ok */
-		q->key = (void *)vkey;		/* initialize new node */
-		q->llink = q->rlink = NULL;
+	if (q == 0)
+		return NULL;
+	/* LINTED const castaway ok */
+	q->key = (void *)vkey;			/* initialize new node */
+	q->llink = q->rlink = NULL;
+	__TSETLINK(path[depth], q);		/* link new node to old */
+
+	/* Walk back up, adjusting balance until some subtree stops growing. */
+	while (--depth >= 0) {
+		int dir, heavy, shrunk;
+
+		p = __TPTR(*path[depth]);
+		dir = path[depth + 1] == &p->rlink;
+		heavy = dir ? 1 : -1;
+		switch (__TBALANCE(p) * heavy) {
+		case 0:
+			__TSETBAL(p, heavy);
+			continue;
+		case -1:
+			__TSETBAL(p, 0);
+			break;
+		default:
+			__TSETLINK(path[depth], __trotate(p, dir, &shrunk));
+			break;
+		}
+		break;
 	}
 	return q;
 }
@@ -34,15 +34,17 @@ trecurse(root, action, level)
 	int level;
 {
 
-	if (root->llink == NULL && root->rlink == NULL)
+	const node_t *l = __TPTR(root->llink), *r = __TPTR(root->rlink);
+
+	if (l == NULL && r == NULL)
 		(*action)(root, leaf, level);
 	else {
 		(*action)(root, preorder, level);
-		if (root->llink != NULL)
-			trecurse(root->llink, action, level + 1);
+		if (l != NULL)
+			trecurse(l, action, level + 1);
 		(*action)(root, postorder, level);
-		if (root->rlink != NULL)
-			trecurse(root->rlink, action, level + 1);
+		if (r != NULL)
+			trecurse(r, action, level + 1);
 		(*action)(root, endorder, level);
 	}
 }
@@ -31,21 +31,10 @@ _asprintf_r (struct _reent *ptr,
 {
   int ret;
   va_list ap;
-  FILE f;
 
-  /* mark a zero-length reallocatable buffer */
-  f._flags = __SWR | __SSTR | __SMBF;
-  f._bf._base = f._p = NULL;
-  f._bf._size = f._w = 0;
-  f._file = -1;  /* No file. */
   va_start (ap, fmt);
-  ret = _svfprintf_r (ptr, &f, fmt, ap);
+  ret = _vasprintf_r (ptr, strp, fmt, ap);
   va_end (ap);
-  if (ret >= 0)
-    {
-      *f._p = 0;
-      *strp = (char *) f._bf._base;
-    }
   return (ret);
 }
 
@@ -63,21 +52,10 @@ asprintf (char **__restrict strp,
 {
   int ret;
   va_list ap;
-  FILE f;
 
-  /* mark a zero-length reallocatable buffer */
-  f._flags = __SWR | __SSTR | __SMBF;
-  f._bf._base = f._p = NULL;
-  f._bf._size = f._w = 0;
-  f._file = -1;  /* No file. */
   va_start (ap, fmt);
-  ret = _svfprintf_r (_REENT, &f, fmt, ap);
+  ret = _vasprintf_r (_REENT, strp, fmt, ap);
   va_end (ap);
-  if (ret >= 0)
-    {
-      *f._p = 0;
-      *strp = (char *) f._bf._base;
-    }
   return (ret);
 }
 
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 1990, 1993
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * This code is derived from software contributed to Berkeley by
+ * Chris Torek.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the University nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+FUNCTION
+<<fgetln>>---get a line from a stream without copying it
+
+INDEX
+	fgetln
+INDEX
+	_fgetln_r
+
+SYNOPSIS
+	#include <stdio.h>
+	char *fgetln(FILE *<[fp]>, size_t *<[len]>);
+
+	char *_fgetln_r(struct _reent *<[ptr]>, FILE *<[fp]>, size_t *<[len]>);
+
+DESCRIPTION
+<<fgetln>> reads the next line from the stream <[fp]> and returns a
+pointer to it, storing its length in *<[len]>.  The line ends with the
+newline, if there was one; it is not a C string, having no
+terminating NUL.
+
+Whenever the whole line is already in the stream's buffer, the pointer
+returned points into that buffer and nothing is copied.  Only a line
+that runs past the end of the buffered data is gathered into a
+separate line buffer belonging to the stream.  Either way the line
+stays valid only until the next I/O call on <[fp]>, and must not be
+modified.
+
+The alternate function <<_fgetln_r>> is a reentrant version.  The
+extra argument <[reent]> is a pointer to a reentrancy structure.
+
+RETURNS
+A pointer to the line, or <<NULL>> with *<[len]> set to 0 at end of
+file or on error; use <<feof>> and <<ferror>> to tell which.
+
+PORTABILITY
+<<fgetln>> is a BSD extension.
+
+Supporting OS subroutines required: <<close>>, <<fstat>>, <<isatty>>,
+<<lseek>>, <<read>>, <<sbrk>>, <<write>>.
+*/
+
+#include <_ansi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "local.h"
+
+/* Room we (optimistically) expect the rest of a line to need, each
+   time we go round for more.  */
+#define OPTIMISTIC 80
+
+/* Make sure the line buffer of FP holds at least SIZE bytes.  */
+static int
+lbexpand (struct _reent *ptr,
+       FILE *fp,
+       size_t size)
+{
+  unsigned char *p;
+
+  if ((size_t) fp->_lb._size >= size)
+    return 0;
+  p = (unsigned char *) _realloc_r (ptr, fp->_lb._base, size);
+  if (p == NULL)
+    return -1;
+  fp->_lb._base = p;
+  fp->_lb._size = size;
+  return 0;
+}
+
+char *
+_fgetln_r (struct _reent *ptr,
+       FILE *fp,
+       size_t *lenp)
+{
+  unsigned char *p;
+  size_t len;
+  size_t off;
+
+  CHECK_INIT (ptr, fp);
+
+  _newlib_flockfile_start (fp);
+  ORIENT (fp, -1);
+
+#ifdef __SCLE
+  if (fp->_flags & __SCLE)
+    {
+      int c;
+
+      /* CR LF has to become LF on the way, as __sgetc_r does it.  */
+      for (len = 0; (c = __sgetc_r (ptr, fp)) != EOF; )
+	{
+	  if (lbexpand (ptr, fp, len + OPTIMISTIC))
+	    goto error;
+	  fp->_lb._base[len++] = c;
+	  if (c == '\n')
+	    break;
+	}
+      if (len == 0)
+	goto eof;
+      *lenp = len;
+      _newlib_flockfile_exit (fp);
+      return (char *) fp->_lb._base;
+    }
+#endif
+
+  /* make sure there is input */
+  if (fp->_r <= 0 && __srefill_r (ptr, fp))
+    goto eof;
+
+  /* look for a newline in the input */
+  if ((p = memchr ((void *) fp->_p, '\n', (size_t) fp->_r)) != NULL)
+    {
+      char *ret;
+
+      p++;		/* advance over it */
+      ret = (char *) fp->_p;
+      *lenp = len = p - fp->_p;
+      fp->_r -= len;
+      fp->_p = p;
+      _newlib_flockfile_exit (fp);
+      return ret;
+    }
+
+  /*
+   * The line runs past the buffered data: gather it in the line
+   * buffer, refilling and looking for the newline until we find it
+   * or hit the end of the file.
+   */
+  for (len = fp->_r, off = 0;; len += fp->_r)
+    {
+      size_t diff;
+
+      if (lbexpand (ptr, fp, len + OPTIMISTIC))
+	goto error;
+      (void) memcpy ((void *) (fp->_lb._base + off), (void *) fp->_p,
+		     len - off);
+      off = len;
+      if (__srefill_r (ptr, fp))
+	{
+	  if (__sfeof (fp))
+	    break;
+	  goto error;
+	}
+      if ((p = memchr ((void *) fp->_p, '\n', (size_t) fp->_r)) == NULL)
+	continue;
+
+      /* got it: finish up the line (like code above) */
+      p++;
+      diff = p - fp->_p;
+      len += diff;
+      if (lbexpand (ptr, fp, len))
+	goto error;
+      (void) memcpy ((void *) (fp->_lb._base + off), (void *) fp->_p, diff);
+      fp->_r -= diff;
+      fp->_p = p;
+      break;
+    }
+  *lenp = len;
+  _newlib_flockfile_exit (fp);
+  return (char *) fp->_lb._base;
+
+error:
+  fp->_flags |= __SERR;
+eof:
+  *lenp = 0;
+  _newlib_flockfile_end (fp);
+  return NULL;
+}
+
+#ifndef _REENT_ONLY
+
+char *
+fgetln (FILE *fp,
+       size_t *lenp)
+{
+  return _fgetln_r (_REENT, fp, lenp);
+}
+
+#endif /* !_REENT_ONLY */
@@ -92,6 +92,7 @@ PORTABILITY
 #include <string.h>
 #include <wchar.h>
 #include "local.h"
+#include "../stdlib/local.h"
 
 #ifdef __IMPL_UNLOCKED__
 #define _fgetws_r _fgetws_unlocked_r
@@ -105,9 +106,11 @@ _fgetws_r (struct _reent *ptr,
 	FILE * fp)
 {
   wchar_t *wsp;
-  size_t nconv;
+  size_t nconv, nbytes, run, i;
   const char *src;
   unsigned char *nl;
+  mbstate_t dummy;
+  int ascii;
 
   _newlib_flockfile_start (fp);
   ORIENT (fp, 1);
@@ -121,32 +124,54 @@ _fgetws_r (struct _reent *ptr,
   if (fp->_r <= 0 && __srefill_r (ptr, fp))
     /* EOF */
     goto error;
+  /* Stateless encodings all read ASCII as itself.  */
+  memset (&dummy, 0, sizeof dummy);
+  ascii = __MBTOWC (ptr, NULL, NULL, 0, &dummy) == 0;
   wsp = ws;
   do
     {
       src = (char *) fp->_p;
       nl = memchr (fp->_p, '\n', fp->_r);
-      nconv = _mbsnrtowcs_r (ptr, wsp, &src,
-			     /* Read all bytes up to the next NL, or up to the
-				end of the buffer if there is no NL. */
-			     nl != NULL ? (nl - fp->_p + 1) : fp->_r,
-			     /* But never more than n - 1 wide chars. */
-			     n - 1,
-			     &fp->_mbstate);
-      if (nconv == (size_t) -1)
-	/* Conversion error */
-	goto error;
-      if (src == NULL)
+      /* Read all bytes up to the next NL, or up to the end of the
+	 buffer if there is no NL. */
+      nbytes = nl != NULL ? (nl - fp->_p + 1) : fp->_r;
+      nconv = 0;
+      if (ascii && fp->_mbstate.__count == 0)
 	{
-	  /*
-	   * We hit a null byte. Increment the character count,
-	   * since mbsnrtowcs()'s return value doesn't include
-	   * the terminating null, then resume conversion
-	   * after the null.
-	   */
-	  nconv++;
-	  src = memchr (fp->_p, '\0', fp->_r);
-	  src++;
+	  /* Widen a leading run of ASCII directly; find it first, so
+	     that the copy is a plain loop.  */
+	  run = nbytes < (size_t) n - 1 ? nbytes : (size_t) n - 1;
+	  while (nconv < run && (unsigned char) src[nconv] < 0x80)
+	    nconv++;
+	  for (i = 0; i < nconv; i++)
+	    wsp[i] = (unsigned char) src[i];
+	  src += nconv;
+	}
+      if (nconv < nbytes && nconv < (size_t) n - 1)
+	{
+	  const char *start = src;
+	  size_t more;
+
+	  more = _mbsnrtowcs_r (ptr, wsp + nconv, &src, nbytes - nconv,
+				/* But never more than n - 1 wide chars. */
+				n - 1 - nconv,
+				&fp->_mbstate);
+	  if (more == (size_t) -1)
+	    /* Conversion error */
+	    goto error;
+	  if (src == NULL)
+	    {
+	      /*
+	       * We hit a null byte. Increment the character count,
+	       * since mbsnrtowcs()'s return value doesn't include
+	       * the terminating null, then resume conversion
+	       * after the null.
+	       */
+	      more++;
+	      src = memchr (start, '\0', nbytes - nconv);
+	      src++;
+	    }
+	  nconv += more;
 	}
       fp->_r -= (unsigned char *) src - fp->_p;
       fp->_p = (unsigned char *) src;
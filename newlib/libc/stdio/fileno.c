@@ -69,7 +69,12 @@ fileno (FILE * f)
   CHECK_INIT (_REENT, f);
   _newlib_flockfile_start (f);
   if (f->_flags)
-    result = __sfileno (f);
+    {
+      if ((f->_flags2 & __SMTMP) && __smtmpspill (_REENT, f) < 0)
+	result = -1;
+      else
+	result = __sfileno (f);
+    }
   else
     {
       result = -1;
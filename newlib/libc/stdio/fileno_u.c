@@ -35,7 +35,12 @@ fileno_unlocked (FILE * f)
   int result;
   CHECK_INIT (_REENT, f);
   if (f->_flags)
-    result = __sfileno (f);
+    {
+      if ((f->_flags2 & __SMTMP) && __smtmpspill (_REENT, f) < 0)
+	result = -1;
+      else
+	result = __sfileno (f);
+    }
   else
     {
       result = -1;
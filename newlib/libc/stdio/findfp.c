@@ -39,6 +39,8 @@ const struct __sFILE_fake __sf_fake_stderr =
 __FILE __sf[3];
 #endif
 
+unsigned long __sdirect_count;
+
 #if (defined (__OPTIMIZE_SIZE__) || defined (PREFER_SIZE_OVER_SPEED))
 _NOINLINE_STATIC void
 #else
@@ -139,6 +141,74 @@ __sfmoreglue (struct _reent *d,
   return &g->glue;
 }
 
+/*
+ * FILEs in the glue blocks __sfp adds are kept on one of two lists,
+ * linked through _lnext and _lprev and guarded by the sfp lock: the
+ * open ones, newest first, on __sfp_live, and the closed ones on
+ * sfp_free.  Only the first, fixed block of _GLOBAL_REENT's glue (the
+ * standard streams, if any) is searched, so finding a slot takes the
+ * same time however many streams have been opened.
+ *
+ * _fwalk follows __sfp_live without the lock.  A FILE taken off that
+ * list keeps its _lnext, and the list only ever grows at its head, so
+ * a walker standing on a closed stream may see some streams twice but
+ * never misses one.
+ */
+
+FILE *__sfp_live;
+static FILE *sfp_free;
+static struct _glue *sfp_lastglue;
+
+/* Put FP, which is not on either list, at the head of __sfp_live.  */
+static void
+sfp_link (FILE *fp)
+{
+  fp->_lprev = NULL;
+  fp->_lnext = __sfp_live;
+  if (__sfp_live != NULL)
+    __sfp_live->_lprev = fp;
+  __sfp_live = fp;
+}
+
+/*
+ * Mark FP, which was open, free for reuse.  Replaces `fp->_flags = 0'
+ * and so must be called with the sfp lock held.
+ */
+void
+__sfp_release (FILE *fp)
+{
+  fp->_flags = 0;
+  if (fp->_lprev == NULL && fp != __sfp_live)
+    return;			/* not one of ours */
+  if (fp->_lnext != NULL)
+    fp->_lnext->_lprev = fp->_lprev;
+  if (fp->_lprev != NULL)
+    fp->_lprev->_lnext = fp->_lnext;
+  else
+    __sfp_live = fp->_lnext;
+  fp->_lprev = sfp_free;
+  sfp_free = fp;
+}
+
+/*
+ * freopen() may bring a closed FILE back to life without __sfp: take
+ * it off the free list again.  Rare, so a search will do.  Called with
+ * the sfp lock held.
+ */
+void
+__sfp_reclaim (FILE *fp)
+{
+  FILE **pp;
+
+  for (pp = &sfp_free; *pp != NULL; pp = &(*pp)->_lprev)
+    if (*pp == fp)
+      {
+	*pp = fp->_lprev;
+	sfp_link (fp);
+	break;
+      }
+}
+
 /*
  * Find a free FILE for fopen et al.
  */
@@ -154,18 +224,32 @@ __sfp (struct _reent *d)
 
   if (!_GLOBAL_REENT->__sdidinit)
     __sinit (_GLOBAL_REENT);
-  for (g = &_GLOBAL_REENT->__sglue;; g = g->_next)
+  g = &_GLOBAL_REENT->__sglue;
+  for (fp = g->_iobs, n = g->_niobs; --n >= 0; fp++)
+    if (fp->_flags == 0)
+      goto found;
+  if (sfp_free == NULL)
     {
-      for (fp = g->_iobs, n = g->_niobs; --n >= 0; fp++)
-	if (fp->_flags == 0)
-	  goto found;
-      if (g->_next == NULL &&
-	  (g->_next = __sfmoreglue (d, NDYNAMIC)) == NULL)
-	break;
+      if (sfp_lastglue == NULL)
+	for (sfp_lastglue = g; sfp_lastglue->_next != NULL; )
+	  sfp_lastglue = sfp_lastglue->_next;
+      if ((g = __sfmoreglue (d, NDYNAMIC)) == NULL)
+	{
+	  _newlib_sfp_lock_exit ();
+	  d->_errno = ENOMEM;
+	  return NULL;
+	}
+      sfp_lastglue->_next = g;
+      sfp_lastglue = g;
+      for (fp = g->_iobs + g->_niobs; fp-- != g->_iobs; )
+	{
+	  fp->_lprev = sfp_free;
+	  sfp_free = fp;
+	}
     }
-  _newlib_sfp_lock_exit ();
-  d->_errno = ENOMEM;
-  return NULL;
+  fp = sfp_free;
+  sfp_free = fp->_lprev;
+  sfp_link (fp);
 
 found:
   fp->_file = -1;		/* no file */
@@ -126,6 +126,7 @@ PORTABILITY
 #include <stdlib.h>
 #include <wchar.h>
 #include "local.h"
+#include "../stdlib/local.h"
 
 wint_t
 __fputwc (struct _reent *ptr,
@@ -161,6 +162,62 @@ __fputwc (struct _reent *ptr,
   return (wint_t) wc;
 }
 
+/*
+ * Write the N wide characters at WS to FP, as N calls to __fputwc
+ * would.  Runs of ASCII go straight into the stream buffer when the
+ * encoding is stateless; every such encoding writes ASCII as itself.
+ * FP must be locked and oriented.  Return 0, or -1 on error.
+ */
+int
+__fputwcs (struct _reent *ptr,
+	const wchar_t *ws,
+	size_t n,
+	FILE *fp)
+{
+  /* A character that has to go through __fputwc to get flushed or
+     converted, if any; 0x80 is never part of an ASCII run anyway.  */
+  wint_t stop = 0x80;
+  int ascii;
+
+  ascii = !(fp->_flags & __SNBF) && __WCTOMB (ptr, NULL, L'\0', NULL) == 0;
+  if (fp->_flags & __SLBF)
+    stop = L'\n';
+#ifdef __SCLE
+  if (fp->_flags & __SCLE)
+    stop = L'\n';
+#endif
+
+  while (n > 0)
+    {
+      if (ascii && fp->_mbstate.__count == 0)
+	{
+	  /* Room left in the buffer; see __sputc_raw_r.  */
+	  int room = fp->_flags & __SLBF ? fp->_w - fp->_lbfsize : fp->_w;
+	  size_t run = room <= 0 ? 0 : n < (size_t) room ? n : (size_t) room;
+	  size_t i, k;
+
+	  /* Find the run first, so that the copy is a plain loop.  */
+	  for (k = 0; k < run && (wint_t) ws[k] < 0x80
+		      && (wint_t) ws[k] != stop; k++)
+	    continue;
+	  if (k > 0)
+	    {
+	      for (i = 0; i < k; i++)
+		fp->_p[i] = (unsigned char) ws[i];
+	      fp->_p += k;
+	      fp->_w -= k;
+	      ws += k;
+	      n -= k;
+	      continue;
+	    }
+	}
+      if (__fputwc (ptr, *ws++, fp) == WEOF)
+	return -1;
+      n--;
+    }
+  return 0;
+}
+
 wint_t
 _fputwc_r (struct _reent *ptr,
 	wchar_t wc,
@@ -103,11 +103,24 @@ _fputws_r (struct _reent *ptr,
 #ifdef _FVWRITE_IN_STREAMIO
   struct __suio uio;
   struct __siov iov;
+#endif
 
   _newlib_flockfile_start (fp);
   ORIENT (fp, 1);
   if (cantwrite (ptr, fp) != 0)
     goto error;
+
+  /* Buffered streams get the string converted straight into the
+     buffer.  Unbuffered ones still want it written in one go.  */
+  if (!(fp->_flags & __SNBF))
+    {
+      if (__fputwcs (ptr, ws, wcslen (ws), fp) != 0)
+	goto error;
+      _newlib_flockfile_exit (fp);
+      return (0);
+    }
+
+#ifdef _FVWRITE_IN_STREAMIO
   uio.uio_iov = &iov;
   uio.uio_iovcnt = 1;
   iov.iov_base = buf;
@@ -121,18 +134,7 @@ _fputws_r (struct _reent *ptr,
 	goto error;
     }
   while (ws != NULL);
-  _newlib_flockfile_exit (fp);
-  return (0);
-
-error:
-  _newlib_flockfile_end (fp);
-  return (-1);
 #else
-  _newlib_flockfile_start (fp);
-  ORIENT (fp, 1);
-  if (cantwrite (ptr, fp) != 0)
-    goto error;
-
   do
     {
       size_t i = 0;
@@ -147,13 +149,13 @@ error:
         }
     }
   while (ws != NULL);
+#endif
   _newlib_flockfile_exit (fp);
   return (0);
 
 error:
   _newlib_flockfile_end (fp);
   return (-1);
-#endif
 }
 
 int
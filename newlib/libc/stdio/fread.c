@@ -84,6 +84,7 @@ Supporting OS subroutines required: <<close>>, <<fstat>>, <<isatty>>,
 #include <stdio.h>
 #include <string.h>
 #include <malloc.h>
+#include <limits.h>
 #include "local.h"
 
 #ifdef __IMPL_UNLOCKED__
@@ -140,6 +141,45 @@ crlf_r (struct _reent * ptr,
 
 #endif
 
+/*
+ * Read up to resid bytes straight into the user's buffer at p, bypassing
+ * the stream's own buffer, which must already be drained.  Return the
+ * number of bytes which could not be read.
+ */
+static size_t
+sreaddirect (struct _reent * ptr,
+       FILE * fp,
+       char * p,
+       size_t resid)
+{
+  /* save fp buffering state */
+  void *old_base = fp->_bf._base;
+  void * old_p = fp->_p;
+  int old_size = fp->_bf._size;
+
+  ++__sdirect_count;
+  while (resid > 0)
+    {
+      int rc;
+      /* allow __refill to use user's buffer */
+      fp->_bf._base = (unsigned char *) p;
+      fp->_bf._size = resid > INT_MAX ? INT_MAX : resid;
+      fp->_p = (unsigned char *) p;
+      rc = __srefill_r (ptr, fp);
+      resid -= fp->_r;
+      p += fp->_r;
+      fp->_r = 0;
+      if (rc)
+	break;
+    }
+
+  /* restore fp buffering back to original state */
+  fp->_bf._base = old_base;
+  fp->_bf._size = old_size;
+  fp->_p = old_p;
+  return resid;
+}
+
 size_t
 _fread_r (struct _reent * ptr,
        void *__restrict buf,
@@ -182,37 +222,17 @@ _fread_r (struct _reent * ptr,
 	FREEUB (ptr, fp);
 
       /* Finally read directly into user's buffer if needed.  */
-      while (resid > 0)
+      if (resid > 0 && (resid = sreaddirect (ptr, fp, p, resid)) != 0)
 	{
-	  int rc = 0;
-	  /* save fp buffering state */
-	  void *old_base = fp->_bf._base;
-	  void * old_p = fp->_p;
-	  int old_size = fp->_bf._size;
-	  /* allow __refill to use user's buffer */
-	  fp->_bf._base = (unsigned char *) p;
-	  fp->_bf._size = resid;
-	  fp->_p = (unsigned char *) p;
-	  rc = __srefill_r (ptr, fp);
-	  /* restore fp buffering back to original state */
-	  fp->_bf._base = old_base;
-	  fp->_bf._size = old_size;
-	  fp->_p = old_p;
-	  resid -= fp->_r;
-	  p += fp->_r;
-	  fp->_r = 0;
-	  if (rc)
-	    {
 #ifdef __SCLE
-              if (fp->_flags & __SCLE)
-	        {
-	          _newlib_flockfile_exit (fp);
-	          return crlf_r (ptr, fp, buf, total-resid, 1) / size;
-	        }
-#endif
+	  if (fp->_flags & __SCLE)
+	    {
 	      _newlib_flockfile_exit (fp);
-	      return (total - resid) / size;
+	      return crlf_r (ptr, fp, buf, total-resid, 1) / size;
 	    }
+#endif
+	  _newlib_flockfile_exit (fp);
+	  return (total - resid) / size;
 	}
     }
   else
@@ -225,6 +245,31 @@ _fread_r (struct _reent * ptr,
 	  /* fp->_r = 0 ... done in __srefill */
 	  p += r;
 	  resid -= r;
+	  /*
+	   * The buffer is now drained.  If the rest of the request is at
+	   * least a bufferful, read it straight into the user's buffer
+	   * rather than copying it through ours.  An ungetc buffer, or a
+	   * stream not yet set up for reading, still goes through
+	   * __srefill_r below.
+	   */
+	  if (!HASUB (fp) && (fp->_flags & __SRD) != 0
+	      && resid >= (fp->_bf._base ? (size_t) fp->_bf._size : BUFSIZ))
+	    {
+	      fp->_r = 0;
+	      if ((resid = sreaddirect (ptr, fp, p, resid)) != 0)
+		{
+#ifdef __SCLE
+		  if (fp->_flags & __SCLE)
+		    {
+		      _newlib_flockfile_exit (fp);
+		      return crlf_r (ptr, fp, buf, total-resid, 1) / size;
+		    }
+#endif
+		  _newlib_flockfile_exit (fp);
+		  return (total - resid) / size;
+		}
+	      break;
+	    }
 	  if (__srefill_r (ptr, fp))
 	    {
 	      /* no more input: return partial result */
@@ -24,10 +24,19 @@
 #include <limits.h>
 #include "local.h"
 #include "fvwrite.h"
+#ifdef HAVE_WRITEV
+#include <sys/uio.h>
+#endif
 
 #define	MIN(a, b) ((a) < (b) ? (a) : (b))
 #define	COPY(n)	  (void) memmove ((void *) fp->_p, (void *) p, (size_t) (n))
 
+#ifdef HAVE_WRITEV
+/* Whether we may bypass fp->_write and use writev on the descriptor.  */
+#define	WRITEV_OK(fp) \
+  ((fp)->_write == __swrite && ((fp)->_flags & __SAPP) == 0)
+#endif
+
 #define GETIOV(extra_work) \
   while (len == 0) \
     { \
@@ -88,6 +97,30 @@ __sfvwrite_r (struct _reent *ptr,
 
   if (fp->_flags & __SNBF)
     {
+      ++__sdirect_count;
+#ifdef HAVE_WRITEV
+      /*
+       * Unbuffered, on a plain descriptor: hand the whole vector to
+       * writev, which coalesces the pieces into as few system calls as
+       * it can.  After a short write, finish off piece by piece below.
+       */
+      if (WRITEV_OK (fp) && uio->uio_iovcnt > 1
+	  && uio->uio_resid <= INT_MAX)
+	{
+	  w = _writev_r (ptr, fp->_file, (const struct iovec *) iov,
+			 uio->uio_iovcnt);
+	  if (w <= 0)
+	    goto err;
+	  fp->_flags &= ~__SOFF;
+	  if ((uio->uio_resid -= w) == 0)
+	    return 0;
+	  while ((size_t) w >= iov->iov_len)
+	    w -= (iov++)->iov_len;
+	  p = (const char *) iov->iov_base + w;
+	  len = iov->iov_len - w;
+	  iov++;
+	}
+#endif
       /*
        * Unbuffered: Split buffer in the largest multiple of BUFSIZ < INT_MAX
        * as some legacy code may expect int instead of size_t.
@@ -179,6 +212,15 @@ __sfvwrite_r (struct _reent *ptr,
 	      fp->_p += w;
 	      w = len;		/* but pretend copied all */
 	    }
+	  else if (fp->_p > fp->_bf._base && len >= fp->_bf._size)
+	    {
+	      /* a bufferful or more after a partial buffer: flush
+		 what we have instead of topping it up, so that the
+		 rest can be written directly below */
+	      if (_fflush_r (ptr, fp))
+		goto err;
+	      w = 0;
+	    }
 	  else if (fp->_p > fp->_bf._base || len < fp->_bf._size)
 	    {
 	      /* pass through the buffer */
@@ -186,13 +228,21 @@ __sfvwrite_r (struct _reent *ptr,
 	      COPY (w);
 	      fp->_w -= w;
 	      fp->_p += w;
-	      if (fp->_w == 0 && _fflush_r (ptr, fp))
-		goto err;
+	      if (fp->_w == 0)
+		{
+		  if (_fflush_r (ptr, fp))
+		    goto err;
+		  /* a whole buffer went out: write more at a time
+		     from now on */
+		  if (__sgrowbuf_r (ptr, fp))
+		    fp->_w = fp->_bf._size;
+		}
 	    }
 	  else
 	    {
 	      /* write directly */
 	      w = ((int)MIN (len, INT_MAX)) / fp->_bf._size * fp->_bf._size;
+	      ++__sdirect_count;
 	      w = fp->_write (ptr, fp->_cookie, p, w);
 	      if (w <= 0)
 		goto err;
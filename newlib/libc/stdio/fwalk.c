@@ -36,15 +36,19 @@ _fwalk (struct _reent *ptr,
   register struct _glue *g;
 
   /*
-   * It should be safe to walk the list without locking it;
-   * new nodes are only added to the end and none are ever
-   * removed.
+   * The first glue block holds the standard streams, if any; every
+   * other stream is on __sfp_live (see findfp.c for why it is safe
+   * to walk that list without locking it).
    *
    * Avoid locking this list while walking it or else you will
    * introduce a potential deadlock in [at least] refill.c.
    */
-  for (g = &ptr->__sglue; g != NULL; g = g->_next)
-    for (fp = g->_iobs, n = g->_niobs; --n >= 0; fp++)
+  g = &ptr->__sglue;
+  for (fp = g->_iobs, n = g->_niobs; --n >= 0; fp++)
+    if (fp->_flags != 0 && fp->_flags != 1 && fp->_file != -1)
+      ret |= (*function) (fp);
+  if (ptr == _GLOBAL_REENT)
+    for (fp = __sfp_live; fp != NULL; fp = fp->_lnext)
       if (fp->_flags != 0 && fp->_flags != 1 && fp->_file != -1)
 	ret |= (*function) (fp);
 
@@ -62,15 +66,19 @@ _fwalk_reent (struct _reent *ptr,
   register struct _glue *g;
 
   /*
-   * It should be safe to walk the list without locking it;
-   * new nodes are only added to the end and none are ever
-   * removed.
+   * The first glue block holds the standard streams, if any; every
+   * other stream is on __sfp_live (see findfp.c for why it is safe
+   * to walk that list without locking it).
    *
    * Avoid locking this list while walking it or else you will
    * introduce a potential deadlock in [at least] refill.c.
    */
-  for (g = &ptr->__sglue; g != NULL; g = g->_next)
-    for (fp = g->_iobs, n = g->_niobs; --n >= 0; fp++)
+  g = &ptr->__sglue;
+  for (fp = g->_iobs, n = g->_niobs; --n >= 0; fp++)
+    if (fp->_flags != 0 && fp->_flags != 1 && fp->_file != -1)
+      ret |= (*reent_function) (ptr, fp);
+  if (ptr == _GLOBAL_REENT)
+    for (fp = __sfp_live; fp != NULL; fp = fp->_lnext)
       if (fp->_flags != 0 && fp->_flags != 1 && fp->_file != -1)
 	ret |= (*reent_function) (ptr, fp);
 
@@ -60,6 +60,23 @@
 #define _STDIO_WITH_THREAD_CANCELLATION_SUPPORT
 #endif
 
+/* Whether a stream oriented critical section has to lock _fp at all.
+   Streams set to FSETLOCKING_BYCALLER never are, and neither is any
+   stream before the retargetable lock layer reports that a second
+   thread has been started: the default single-threaded lock routines
+   provide __retarget_lock_single_threaded set for good, a platform
+   with real locks may provide it and clear it when it creates the
+   first thread.  If it does not provide it, we always lock. */
+#ifdef _RETARGETABLE_LOCKING
+extern int __retarget_lock_single_threaded _ATTRIBUTE((__weak__));
+# define _newlib_flockfile_needed(_fp) \
+	(!((_fp)->_flags2 & __SNLK) \
+	 && (&__retarget_lock_single_threaded == NULL \
+	     || !__retarget_lock_single_threaded))
+#else
+# define _newlib_flockfile_needed(_fp) (!((_fp)->_flags2 & __SNLK))
+#endif
+
 #if defined(__SINGLE_THREAD__) || defined(__IMPL_UNLOCKED__)
 
 # define _newlib_flockfile_start(_fp)
@@ -76,21 +93,28 @@
 # define _newlib_flockfile_start(_fp) \
 	{ \
 	  int __oldfpcancel; \
-	  pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, &__oldfpcancel); \
-	  if (!(_fp->_flags2 & __SNLK)) \
-	    _flockfile (_fp)
+	  int __fplocked = _newlib_flockfile_needed (_fp); \
+	  if (__fplocked) \
+	    { \
+	      pthread_setcancelstate (PTHREAD_CANCEL_DISABLE, &__oldfpcancel); \
+	      _flockfile (_fp); \
+	    }
 
 /* Exit from a stream oriented critical section prematurely: */
 # define _newlib_flockfile_exit(_fp) \
-	  if (!(_fp->_flags2 & __SNLK)) \
-	    _funlockfile (_fp); \
-	  pthread_setcancelstate (__oldfpcancel, &__oldfpcancel);
+	  if (__fplocked) \
+	    { \
+	      _funlockfile (_fp); \
+	      pthread_setcancelstate (__oldfpcancel, &__oldfpcancel); \
+	    }
 
 /* End a stream oriented critical section: */
 # define _newlib_flockfile_end(_fp) \
-	  if (!(_fp->_flags2 & __SNLK)) \
-	    _funlockfile (_fp); \
-	  pthread_setcancelstate (__oldfpcancel, &__oldfpcancel); \
+	  if (__fplocked) \
+	    { \
+	      _funlockfile (_fp); \
+	      pthread_setcancelstate (__oldfpcancel, &__oldfpcancel); \
+	    } \
 	}
 
 /* Start a stream list oriented critical section: */
@@ -115,15 +139,16 @@
 
 # define _newlib_flockfile_start(_fp) \
 	{ \
-		if (!(_fp->_flags2 & __SNLK)) \
+		int __fplocked = _newlib_flockfile_needed (_fp); \
+		if (__fplocked) \
 		  _flockfile (_fp)
 
 # define _newlib_flockfile_exit(_fp) \
-		if (!(_fp->_flags2 & __SNLK)) \
+		if (__fplocked) \
 		  _funlockfile(_fp); \
 
 # define _newlib_flockfile_end(_fp) \
-		if (!(_fp->_flags2 & __SNLK)) \
+		if (__fplocked) \
 		  _funlockfile(_fp); \
 	}
 
@@ -142,7 +167,9 @@
 
 extern wint_t __fgetwc (struct _reent *, FILE *);
 extern wint_t __fputwc (struct _reent *, wchar_t, FILE *);
+extern int    __fputwcs (struct _reent *, const wchar_t *, size_t, FILE *);
 extern u_char *__sccl (char *, u_char *fmt);
+extern int    __sscandec (FILE *, size_t, int, u_long *);
 extern int    __svfscanf_r (struct _reent *,FILE *, const char *,va_list);
 extern int    __ssvfscanf_r (struct _reent *,FILE *, const char *,va_list);
 extern int    __svfiscanf_r (struct _reent *,FILE *, const char *,va_list);
@@ -162,6 +189,8 @@ int	      _svfwprintf_r (struct _reent *, FILE *, const wchar_t *,
 int	      _svfiwprintf_r (struct _reent *, FILE *, const wchar_t *, 
 				  va_list);
 extern FILE  *__sfp (struct _reent *);
+extern void   __sfp_release (FILE *);
+extern void   __sfp_reclaim (FILE *);
 extern int    __sflags (struct _reent *,const char*, int*);
 extern int    __sflush_r (struct _reent *,FILE *);
 #ifdef _STDIO_BSD_SEMANTICS
@@ -186,8 +215,35 @@ extern int    __swhatbuf_r (struct _reent *, FILE *, size_t *, int *);
 extern int    _fwalk (struct _reent *, int (*)(FILE *));
 extern int    _fwalk_reent (struct _reent *, int (*)(struct _reent *, FILE *));
 struct _glue * __sfmoreglue (struct _reent *,int n);
+extern FILE  *__sfp_live;
+
+/* A tmpfile stream with __SMTMP set keeps its contents in memory.  Its
+   cookie starts with a function that moves them to a real file, for
+   callers that need a descriptor; calling through it keeps those
+   callers from pulling in tmpfile.  */
+#define __smtmpspill(ptr, fp) \
+  ((*(int (**) (struct _reent *, FILE *)) (fp)->_cookie) ((ptr), (fp)))
 extern int __submore (struct _reent *, FILE *);
 
+/* A stream that keeps filling or draining its whole buffer gets a
+   buffer twice as big, up to this size, so that long sequential reads
+   and writes take fewer system calls.  Only buffers that stdio chose
+   itself (__SSEQ) grow.  0 turns this off.  */
+#ifndef _STDIO_SEQ_BUFSIZ_MAX
+# if __INT_MAX__ <= 32767
+#  define _STDIO_SEQ_BUFSIZ_MAX 1024
+# else
+#  define _STDIO_SEQ_BUFSIZ_MAX 65536
+# endif
+#endif
+extern int __sgrowbuf_r (struct _reent *, FILE *);
+
+/* Number of times data has moved directly between the user's memory
+   and the file: by fread, or by any write through __sfvwrite_r, because
+   the stream is unbuffered or the request was large enough to bypass
+   the stream buffer.  Read it with __fdirectcount.  */
+extern unsigned long __sdirect_count;
+
 #ifdef __LARGE64_FILES
 extern _fpos64_t __sseek64 (struct _reent *, void *, _fpos64_t, int);
 extern _READ_WRITE_RETURN_TYPE __swrite64 (struct _reent *, void *,
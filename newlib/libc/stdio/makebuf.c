@@ -63,6 +63,8 @@ __smakebuf_r (struct _reent *ptr,
     {
       ptr->__cleanup = _cleanup_r;
       fp->_flags |= __SMBF;
+      if (!(fp->_flags & __SSTR))
+	fp->_flags2 |= __SSEQ;
       fp->_bf._base = fp->_p = (unsigned char *) p;
       fp->_bf._size = size;
       if (couldbetty && _isatty_r (ptr, fp->_file))
@@ -71,6 +73,38 @@ __smakebuf_r (struct _reent *ptr,
     }
 }
 
+/*
+ * Replace the empty buffer of a fully buffered stream that has just
+ * used all of it by one twice the size, bounded by
+ * _STDIO_SEQ_BUFSIZ_MAX.  Return nonzero if the buffer was replaced;
+ * _p then points at its start, and the caller resets _r or _w.  If
+ * memory is short, keep the buffer we have and stop trying.
+ */
+int
+__sgrowbuf_r (struct _reent *ptr,
+       register FILE *fp)
+{
+  size_t size;
+  void *p;
+
+  if (!(fp->_flags2 & __SSEQ)
+      || fp->_flags & (__SLBF | __SNBF)
+      || (size_t) fp->_bf._size >= _STDIO_SEQ_BUFSIZ_MAX)
+    return 0;
+  size = (size_t) fp->_bf._size * 2;
+  if (size > _STDIO_SEQ_BUFSIZ_MAX)
+    size = _STDIO_SEQ_BUFSIZ_MAX;
+  if ((p = _malloc_r (ptr, size)) == NULL)
+    {
+      fp->_flags2 &= ~__SSEQ;
+      return 0;
+    }
+  _free_r (ptr, fp->_bf._base);
+  fp->_bf._base = fp->_p = (unsigned char *) p;
+  fp->_bf._size = size;
+  return 1;
+}
+
 /*
  * Internal routine to determine `proper' buffering for a file.
  */
@@ -476,10 +476,9 @@ _VFPRINTF_R (struct _reent *data,
        const char *fmt0,
        va_list ap)
 {
-  register char *fmt;	/* Format string.  */
-  register int n, m;	/* Handy integers (short term usage).  */
-  register char *cp;	/* Handy char pointer (short term usage).  */
-  const char *flag_chars;
+  const char *fmt;	/* Format string.  */
+  int n;		/* Handy integer (short term usage).  */
+  struct _prt_spec_t spec;	/* The conversion being printed.  */
   struct _prt_data_t prt_data;	/* All data for decoding format string.  */
   va_list ap_copy;
 
@@ -514,7 +513,7 @@ _VFPRINTF_R (struct _reent *data,
     }
 #endif
 
-  fmt = (char *)fmt0;
+  fmt = fmt0;
   prt_data.ret = 0;
   prt_data.blank = ' ';
   prt_data.zero = '0';
@@ -525,122 +524,16 @@ _VFPRINTF_R (struct _reent *data,
   /* Scan the format for conversions (`%' character).  */
   for (;;)
     {
-      cp = fmt;
-      while (*fmt != '\0' && *fmt != '%')
-	fmt += 1;
-
-      if ((m = fmt - cp) != 0)
+      fmt = _printf_parse (fmt, &spec);
+      if (spec.litlen != 0)
 	{
-	  PRINT (cp, m);
-	  prt_data.ret += m;
+	  PRINT (spec.lit, spec.litlen);
+	  prt_data.ret += spec.litlen;
 	}
-      if (*fmt == '\0')
+      if (fmt == NULL)
 	goto done;
 
-      fmt++;		/* Skip over '%'.  */
-
-      prt_data.flags = 0;
-      prt_data.width = 0;
-      prt_data.prec = -1;
-      prt_data.dprec = 0;
-      prt_data.l_buf[0] = '\0';
-#ifdef FLOATING_POINT
-      prt_data.lead = 0;
-#endif
-      /* The flags.  */
-      /*
-       * ``Note that 0 is taken as a flag, not as the
-       * beginning of a field width.''
-       *	-- ANSI X3J11
-       */
-      flag_chars = "#-0+ ";
-      for (; cp = memchr (flag_chars, *fmt, 5); fmt++)
-	prt_data.flags |= (1 << (cp - flag_chars));
-
-      if (prt_data.flags & SPACESGN)
-	prt_data.l_buf[0] = ' ';
-
-      /*
-       * ``If the space and + flags both appear, the space
-       * flag will be ignored.''
-       *	-- ANSI X3J11
-       */
-      if (prt_data.flags & PLUSSGN)
-	prt_data.l_buf[0] = '+';
-
-      /* The width.  */
-      if (*fmt == '*')
-	{
-	  /*
-	   * ``A negative field width argument is taken as a
-	   * - flag followed by a positive field width.''
-	   *	-- ANSI X3J11
-	   * They don't exclude field widths read from args.
-	   */
-	  prt_data.width = GET_ARG (n, ap_copy, int);
-	  if (prt_data.width < 0)
-	    {
-	      prt_data.width = -prt_data.width;
-	      prt_data.flags |= LADJUST;
-	    }
-	  fmt++;
-	}
-      else
-        {
-	  for (; is_digit (*fmt); fmt++)
-	    prt_data.width = 10 * prt_data.width + to_digit (*fmt);
-	}
-
-      /* The precision.  */
-      if (*fmt == '.')
-	{
-	  fmt++;
-	  if (*fmt == '*')
-	    {
-	      fmt++;
-	      prt_data.prec = GET_ARG (n, ap_copy, int);
-	      if (prt_data.prec < 0)
-		prt_data.prec = -1;
-	    }
-	  else
-	    {
-	      prt_data.prec = 0;
-	      for (; is_digit (*fmt); fmt++)
-		prt_data.prec = 10 * prt_data.prec + to_digit (*fmt);
-	    }
-	}
-
-      /* The length modifiers.  */
-      flag_chars = "hlL";
-      if ((cp = memchr (flag_chars, *fmt, 3)) != NULL)
-	{
-	  prt_data.flags |= (SHORTINT << (cp - flag_chars));
-	  fmt++;
-	}
-
-      /* The conversion specifiers.  */
-      prt_data.code = *fmt++;
-      cp = memchr ("efgEFG", prt_data.code, 6);
-#ifdef FLOATING_POINT
-      /* If cp is not NULL, we are facing FLOATING POINT NUMBER.  */
-      if (cp)
-	{
-	  /* Consume floating point argument if _printf_float is not
-	     linked.  */
-	  if (_printf_float == NULL)
-	    {
-	      if (prt_data.flags & LONGDBL)
-		GET_ARG (N, ap_copy, _LONG_DOUBLE);
-	      else
-		GET_ARG (N, ap_copy, double);
-	    }
-	  else
-            n = _printf_float (data, &prt_data, fp, pfunc, &ap_copy);
-	}
-      else
-#endif
-	n = _printf_i (data, &prt_data, fp, pfunc, &ap_copy);
-
+      n = _printf_conv (data, &prt_data, &spec, fp, pfunc, &ap_copy);
       if (n == -1)
 	goto error;
 
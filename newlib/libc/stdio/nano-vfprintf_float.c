@@ -239,6 +239,10 @@ _printf_float (struct _reent *data,
   cp = __cvt (data, _fpvalue, pdata->prec, pdata->flags, &softsign,
 	      &expt, code, &ndig, cp);
 
+  /* Only infinity and NaN are spelled differently by 'F'.  */
+  if (code == 'F')
+    code = 'f';
+
   if (code == 'g' || code == 'G')
     {
       if (expt <= -4 || expt > pdata->prec)
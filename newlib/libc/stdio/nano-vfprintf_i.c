@@ -91,7 +91,8 @@ _printf_common (struct _reent *data,
       pdata->l_buf[n++] = pdata->l_buf[2];
     }
 
-  PRINT (pdata->l_buf, n);
+  if (n != 0)
+    PRINT (pdata->l_buf, n);
   n = pdata->width - *realsz;
   if ((pdata->flags & (LADJUST|ZEROPAD)) != ZEROPAD || n < 0)
     n = 0;
@@ -186,16 +187,26 @@ number:
        */
       if (_uquad != 0 || pdata->prec != 0)
 	{
-	  do
-	    {
-	      *--cp = xdigs[_uquad % base];
-	      _uquad /= base;
-	    }
-	  while (_uquad);
+	  /* Constant divisors are much cheaper than a variable one.  */
+	  if (base == 10)
+	    do
+	      {
+		*--cp = to_char (_uquad % 10);
+		_uquad /= 10;
+	      }
+	    while (_uquad);
+	  else
+	    do
+	      {
+		*--cp = xdigs[_uquad & (base - 1)];
+		_uquad >>= (base == 8 ? 3 : 4);
+	      }
+	    while (_uquad);
 	}
       /* For 'o' conversion, '#' increases the precision to force the first
 	 digit of the result to be zero.  */
-      if (base == 8 && (pdata->flags & ALT) && pdata->prec <= pdata->size)
+      if (base == 8 && (pdata->flags & ALT)
+	  && (cp == pdata->buf + BUF || *cp != '0'))
 	*--cp = '0';
 
       pdata->size = pdata->buf + BUF - cp;
@@ -212,6 +223,11 @@ number:
       break;
     case 's':
       cp = GET_ARG (N, *ap, char_ptr_t);
+#ifndef __OPTIMIZE_SIZE__
+      /* Mirror vfprintf, which prints a NULL string as glibc does.  */
+      if (cp == NULL)
+	cp = "(null)";
+#endif
       /* Precision gives the maximum number of chars to be written from a
 	 string, and take prec == -1 into consideration.
 	 Use normal Newlib approach here to support case where cp is not
@@ -248,3 +264,151 @@ error:
     return -1;
 }
 
+
+/* Split off the literal text at FMT and the conversion after it into
+   SPEC.  Return a pointer past the conversion, or NULL if the format
+   ended first.  */
+const char *
+_printf_parse (const char *fmt, struct _prt_spec_t *spec)
+{
+  const char *cp;
+  const char *flag_chars;
+
+  spec->lit = fmt;
+  while (*fmt != '\0' && *fmt != '%')
+    fmt += 1;
+  spec->litlen = fmt - spec->lit;
+  spec->flags = 0;
+  spec->width = 0;
+  spec->prec = -1;
+  spec->code = '\0';
+  if (*fmt == '\0')
+    return NULL;
+
+  fmt++;		/* Skip over '%'.  */
+
+  /* The flags.  */
+  /*
+   * ``Note that 0 is taken as a flag, not as the
+   * beginning of a field width.''
+   *	-- ANSI X3J11
+   */
+  flag_chars = "#-0+ ";
+  for (; cp = memchr (flag_chars, *fmt, 5); fmt++)
+    spec->flags |= (1 << (cp - flag_chars));
+
+  /* The width.  */
+  if (*fmt == '*')
+    {
+      spec->width = STAR_ARG;
+      fmt++;
+    }
+  else
+    {
+      for (; is_digit (*fmt); fmt++)
+	spec->width = 10 * spec->width + to_digit (*fmt);
+    }
+
+  /* The precision.  */
+  if (*fmt == '.')
+    {
+      fmt++;
+      if (*fmt == '*')
+	{
+	  fmt++;
+	  spec->prec = STAR_ARG;
+	}
+      else
+	{
+	  spec->prec = 0;
+	  for (; is_digit (*fmt); fmt++)
+	    spec->prec = 10 * spec->prec + to_digit (*fmt);
+	}
+    }
+
+  /* The length modifiers.  */
+  flag_chars = "hlL";
+  if ((cp = memchr (flag_chars, *fmt, 3)) != NULL)
+    {
+      spec->flags |= (SHORTINT << (cp - flag_chars));
+      fmt++;
+    }
+
+  /* The conversion specifier.  A lone `%' ends the format.  */
+  if ((spec->code = *fmt) == '\0')
+    return NULL;
+  return fmt + 1;
+}
+
+/* Print one conversion as parsed by _printf_parse.  */
+int
+_printf_conv (struct _reent *data,
+	      struct _prt_data_t *pdata,
+	      const struct _prt_spec_t *spec,
+	      FILE *fp,
+	      int (*pfunc)(struct _reent *, FILE *,
+			   const char *, size_t len),
+	      va_list *ap)
+{
+  pdata->flags = spec->flags;
+  pdata->width = spec->width;
+  pdata->prec = spec->prec;
+  pdata->dprec = 0;
+  pdata->l_buf[0] = '\0';
+#ifdef FLOATING_POINT
+  pdata->lead = 0;
+#endif
+  if (pdata->flags & SPACESGN)
+    pdata->l_buf[0] = ' ';
+
+  /*
+   * ``If the space and + flags both appear, the space
+   * flag will be ignored.''
+   *	-- ANSI X3J11
+   */
+  if (pdata->flags & PLUSSGN)
+    pdata->l_buf[0] = '+';
+
+  if (pdata->width == STAR_ARG)
+    {
+      /*
+       * ``A negative field width argument is taken as a
+       * - flag followed by a positive field width.''
+       *	-- ANSI X3J11
+       * They don't exclude field widths read from args.
+       */
+      pdata->width = GET_ARG (N, *ap, int);
+      if (pdata->width < 0)
+	{
+	  pdata->width = -pdata->width;
+	  pdata->flags |= LADJUST;
+	}
+    }
+  if (pdata->prec == STAR_ARG)
+    {
+      pdata->prec = GET_ARG (N, *ap, int);
+      if (pdata->prec < 0)
+	pdata->prec = -1;
+    }
+
+  pdata->code = spec->code;
+#ifdef FLOATING_POINT
+  if (memchr ("efgEFG", pdata->code, 6))
+    {
+#ifdef _NANO_FORMATTED_IO
+      /* Consume floating point argument if _printf_float is not
+	 linked.  */
+      if (_printf_float == NULL)
+	{
+	  if (pdata->flags & LONGDBL)
+	    GET_ARG (N, *ap, _LONG_DOUBLE);
+	  else
+	    GET_ARG (N, *ap, double);
+	  return 0;
+	}
+#endif
+      return _printf_float (data, pdata, fp, pfunc, ap);
+    }
+#endif
+  return _printf_i (data, pdata, fp, pfunc, ap);
+}
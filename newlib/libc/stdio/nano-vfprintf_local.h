@@ -170,13 +170,16 @@ typedef short *  short_ptr_t;
 	if (pfunc (data, fp, (ptr), (len)) == EOF) \
 		goto error;		\
 }
+#define PADSIZE 16
 #define PAD(howmany, ch) {             \
-       int temp_i = 0;                 \
-       while (temp_i < (howmany))      \
+       int temp_i = (howmany);         \
+       while (temp_i > 0)              \
        {                               \
-               if (pfunc (data, fp, &(ch), 1) == EOF) \
+               int temp_n = temp_i < PADSIZE ? temp_i : PADSIZE; \
+               if (pfunc (data, fp, (ch) == '0' ? "0000000000000000" \
+				 : "                ", temp_n) == EOF) \
                        goto error;     \
-               temp_i++;               \
+               temp_i -= temp_n;       \
        }			       \
 }
 #define PRINTANDPAD(p, ep, len, ch) {  \
@@ -209,6 +212,33 @@ struct _prt_data_t
 #endif
 };
 
+/* A format string is cut into conversions, each with the literal text
+   that precedes it.  A `*' width or precision is recorded as STAR_ARG
+   and fetched from the argument list when the conversion is printed.  */
+#define STAR_ARG	(-2)
+
+struct _prt_spec_t
+{
+  const char *lit;	/* Literal text before the conversion.  */
+  size_t litlen;	/* Length of the literal text.  */
+  int flags;		/* Flags and length modifier.  */
+  int width;		/* Width, or STAR_ARG.  */
+  int prec;		/* Precision, -1 if none, or STAR_ARG.  */
+  char code;		/* Conversion specifier, '\0' after the last.  */
+};
+
+extern const char *
+_printf_parse (const char *fmt, struct _prt_spec_t *spec);
+
+extern int
+_printf_conv (struct _reent *data,
+	      struct _prt_data_t *pdata,
+	      const struct _prt_spec_t *spec,
+	      FILE *fp,
+	      int (*pfunc)(struct _reent *, FILE *,
+			   const char *, size_t len),
+	      va_list *ap);
+
 extern int
 _printf_common (struct _reent *data,
 		struct _prt_data_t *pdata,
@@ -223,12 +253,17 @@ _printf_i (struct _reent *data, struct _prt_data_t *pdata, FILE *fp,
 	   va_list *ap);
 
 /* Make _printf_float weak symbol, so it won't be linked in if target program
-   does not need it.  */
+   does not need it.  Without nano formatted IO the helpers only serve
+   compiled formats, which should print floats just as vfprintf does.  */
 extern int
 _printf_float (struct _reent *data,
 	       struct _prt_data_t *pdata,
 	       FILE *fp,
 	       int (*pfunc)(struct _reent *, FILE *,
 			    const char *, size_t len),
-	       va_list *ap) _ATTRIBUTE((__weak__));
+	       va_list *ap)
+#ifdef _NANO_FORMATTED_IO
+	       _ATTRIBUTE((__weak__))
+#endif
+	       ;
 #endif
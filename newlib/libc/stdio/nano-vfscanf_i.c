@@ -106,6 +106,16 @@ _scanf_i (struct _reent *rptr,
   /* Scan an integer as if by strtol/strtoul.  */
   unsigned width_left = 0;
   int skips = 0;
+  u_long ul = 0;
+
+  /* Decimal numbers are usually in the buffer whole, and in range:
+     convert those right there.  */
+  if (pdata->base == 10
+      && (n = __sscandec (fp, pdata->width, pdata->code != CT_INT, &ul)) > 0)
+    {
+      pdata->nread += n;
+      goto assign;
+    }
 
   ccfn = (pdata->code == CT_INT) ? (u_long (*)CCFN_PARAMS)_strtol_r : _strtoul_r;
 #ifdef hardway
@@ -212,9 +222,13 @@ match_end:
     }
   if ((pdata->flags & SUPPRESS) == 0)
     {
-      u_long ul;
       *p = 0;
       ul = (*ccfn) (rptr, pdata->buf, (char **) NULL, pdata->base);
+    }
+  pdata->nread += p - pdata->buf + skips;
+assign:
+  if ((pdata->flags & SUPPRESS) == 0)
+    {
       if (pdata->flags & POINTER)
 	*GET_ARG (N, *ap, void **) = (void *) (uintptr_t) ul;
       else if (pdata->flags & SHORT)
@@ -226,7 +240,6 @@ match_end:
       
       pdata->nassigned++;
     }
-  pdata->nread += p - pdata->buf + skips;
   return 0;
 }
 
@@ -11,6 +11,8 @@ INDEX
 	open_memstream
 INDEX
 	open_wmemstream
+INDEX
+	memstream_reserve
 
 SYNOPSIS
 	#include <stdio.h>
@@ -21,6 +23,9 @@ SYNOPSIS
 	FILE *open_wmemstream(wchar_t **restrict <[buf]>,
 			      size_t *restrict <[size]>);
 
+	#include <stdio.h>
+	int memstream_reserve(FILE *<[fp]>, size_t <[size]>);
+
 DESCRIPTION
 <<open_memstream>> creates a seekable, byte-oriented <<FILE>> stream that
 wraps an arbitrary-length buffer, created as if by <<malloc>>.  The current
@@ -49,14 +54,25 @@ in case of <<open_wmemstream>>).  However, data previously written beyond
 the current stream offset is not lost, and the NUL value written during a
 flush is restored to its previous value when seeking elsewhere in the string.
 
+The initial allocation follows the hint in *<[size]> only up to 64k
+bytes, in case *<[size]> was garbage.  A caller that knows roughly how
+much it will write can call <<memstream_reserve>> on the open stream to
+allocate room for <[size]> bytes (or wide characters) at once, so that
+the buffer is not reallocated and copied as it grows.
+
 RETURNS
 The return value is an open FILE pointer on success.  On error,
 <<NULL>> is returned, and <<errno>> will be set to EINVAL if <[buf]>
 or <[size]> is NULL, ENOMEM if memory could not be allocated, or
 EMFILE if too many streams are already open.
 
+<<memstream_reserve>> returns 0 on success.  On error, it returns
+<<EOF>> and sets <<errno>> to EINVAL if <[fp]> is not a memstream, or
+ENOMEM if memory could not be allocated; the stream is unchanged.
+
 PORTABILITY
-POSIX.1-2008
+<<open_memstream>> and <<open_wmemstream>> are POSIX.1-2008.
+<<memstream_reserve>> is a newlib extension.
 
 Supporting OS subroutines required: <<sbrk>>.
 */
@@ -309,7 +325,7 @@ internal_open_memstream_r (struct _reent *ptr,
   if ((c = (memstream *) _malloc_r (ptr, sizeof *c)) == NULL)
     {
       _newlib_sfp_lock_start ();
-      fp->_flags = 0;		/* release */
+      __sfp_release (fp);		/* release */
 #ifndef __SINGLE_THREAD__
       __lock_close_recursive (fp->_lock);
 #endif
@@ -334,7 +350,7 @@ internal_open_memstream_r (struct _reent *ptr,
   if (!*buf)
     {
       _newlib_sfp_lock_start ();
-      fp->_flags = 0;		/* release */
+      __sfp_release (fp);		/* release */
 #ifndef __SINGLE_THREAD__
       __lock_close_recursive (fp->_lock);
 #endif
@@ -388,7 +404,59 @@ _open_wmemstream_r (struct _reent *ptr,
   return internal_open_memstream_r (ptr, (char **)buf, size, 1);
 }
 
+/* Make room in the memstream FP for SIZE bytes (wide characters for
+   open_wmemstream), plus the trailing NUL.  */
+int
+_memstream_reserve_r (struct _reent *ptr,
+       FILE *fp,
+       size_t size)
+{
+  memstream *c;
+  char *buf;
+  int ret = 0;
+
+  _newlib_flockfile_start (fp);
+  if (fp->_write != memwriter)
+    {
+      ptr->_errno = EINVAL;
+      ret = EOF;
+    }
+  else
+    {
+      c = (memstream *) fp->_cookie;
+      if (c->wide > 0)
+	{
+	  if (size > (SIZE_MAX - 1) / sizeof (wchar_t))
+	    size = SIZE_MAX;
+	  else
+	    size = (size + 1) * sizeof (wchar_t);
+	}
+      else if (size < SIZE_MAX)
+	size++;
+      if (size > c->max)
+	{
+	  buf = _realloc_r (ptr, *c->pbuf, size);
+	  if (buf == NULL)
+	    ret = EOF; /* errno already set to ENOMEM */
+	  else
+	    {
+	      *c->pbuf = buf;
+	      c->max = size;
+	    }
+	}
+    }
+  _newlib_flockfile_end (fp);
+  return ret;
+}
+
 #ifndef _REENT_ONLY
+int
+memstream_reserve (FILE *fp,
+       size_t size)
+{
+  return _memstream_reserve_r (_REENT, fp, size);
+}
+
 FILE *
 open_memstream (char **buf,
        size_t *size)
@@ -0,0 +1,318 @@
+/*
+FUNCTION
+<<printf_compile>>, <<vfprintf_compiled>>---format output with a format parsed in advance
+
+INDEX
+	printf_compile
+INDEX
+	_printf_compile_r
+INDEX
+	fprintf_compiled
+INDEX
+	vfprintf_compiled
+INDEX
+	_vfprintf_compiled_r
+
+SYNOPSIS
+	#include <stdio.h>
+	#include <stdarg.h>
+	printf_fmt_t *printf_compile(const char *<[fmt]>);
+	int fprintf_compiled(FILE *<[fp]>, const printf_fmt_t *<[pf]>, ...);
+	int vfprintf_compiled(FILE *<[fp]>, const printf_fmt_t *<[pf]>,
+			      va_list <[list]>);
+
+	printf_fmt_t *_printf_compile_r(struct _reent *<[reent]>,
+				       const char *<[fmt]>);
+	int _vfprintf_compiled_r(struct _reent *<[reent]>, FILE *<[fp]>,
+				 const printf_fmt_t *<[pf]>, va_list <[list]>);
+
+DESCRIPTION
+<<printf_compile>> parses the <<printf>> format <[fmt]> once, into
+a list of conversions (flags, width, precision, length modifier and
+specifier) and the literal text between them.  <<fprintf_compiled>>
+and <<vfprintf_compiled>> then print their arguments to <[fp]> exactly
+as <<fprintf>> and <<vfprintf>> would with <[fmt]>, without parsing
+it again.  This pays off when the same format is printed many times.
+
+The compiled format keeps its own copy of <[fmt]> and is a single
+allocation; release it with <<free>>.  It may be used by several
+threads at once.
+
+Conversions are run by the engine of the small-footprint printf.  A
+format it cannot print just as <<vfprintf>> would---one with
+positional arguments, the <<hh>>, <<ll>>, <<j>>, <<z>> or <<t>>
+modifiers, wide characters, <<%a>>, or (outside nano formatted IO)
+<<long double>>---is still accepted, but is handed to <<vfprintf>>
+whole each time it is printed.
+
+RETURNS
+<<printf_compile>> returns the compiled format, or <<NULL>> if memory
+could not be allocated.  <<fprintf_compiled>> and
+<<vfprintf_compiled>> return the number of bytes written, or <<EOF>>
+on error.
+
+PORTABILITY
+These functions are newlib extensions.
+
+Supporting OS subroutines required: <<close>>, <<fstat>>, <<isatty>>,
+<<lseek>>, <<read>>, <<sbrk>>, <<write>>.
+*/
+
+#include <newlib.h>
+#include <_ansi.h>
+#include <reent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+#include <wchar.h>
+#include <sys/lock.h>
+#include <stdarg.h>
+#include "local.h"
+#include "../stdlib/local.h"
+#include "fvwrite.h"
+#include "vfieeefp.h"
+#include "nano-vfprintf_local.h"
+
+struct __printf_fmt
+{
+  int nspec;			/* Conversions, or -1 to use vfprintf.  */
+  const char *fmt;		/* Our copy of the format.  */
+  struct _prt_spec_t spec[1];	/* nspec + 1, the last just literal.  */
+};
+
+/* Can SPEC be printed by _printf_conv exactly as vfprintf prints it?  */
+static int
+supported (const struct _prt_spec_t *spec)
+{
+  if (spec->code == '\0'
+      || !strchr ("diouxXcspn%eEfFgG", spec->code))
+    return 0;
+  if ((spec->code == 'c' || spec->code == 's') && spec->flags & LONGINT)
+    return 0;
+#ifndef _NANO_FORMATTED_IO
+  /* The nano engine prints a null pointer as "0", vfprintf as "0x0".  */
+  if (spec->code == 'p')
+    return 0;
+  /* The nano engine prints long double only to the precision of
+     double.  */
+  if (spec->flags & LONGDBL && strchr ("eEfFgG", spec->code))
+    return 0;
+#ifndef _WANT_IO_C99_FORMATS
+  if (spec->code == 'F')
+    return 0;
+#endif
+#endif
+  return 1;
+}
+
+printf_fmt_t *
+_printf_compile_r (struct _reent *ptr,
+       const char *fmt)
+{
+  struct _prt_spec_t spec;
+  printf_fmt_t *pf;
+  const char *p;
+  size_t len = strlen (fmt) + 1;
+  int n = 0;
+
+  for (p = fmt; (p = _printf_parse (p, &spec)) != NULL; n++)
+    if (!supported (&spec))
+      {
+	n = -1;
+	break;
+      }
+  /* A `%' just before the end would show up as a missing conversion.  */
+  if (n >= 0 && spec.lit + spec.litlen != fmt + len - 1)
+    n = -1;
+
+  pf = (printf_fmt_t *) _malloc_r (ptr, sizeof (printf_fmt_t)
+				   + (n > 0 ? n : 0)
+				     * sizeof (struct _prt_spec_t)
+				   + len);
+  if (pf == NULL)
+    return NULL;
+  pf->nspec = n;
+  pf->fmt = memcpy ((char *) &pf->spec[n > 0 ? n + 1 : 1], fmt, len);
+  if (n >= 0)
+    {
+      p = pf->fmt;
+      for (n = 0; (p = _printf_parse (p, &pf->spec[n])) != NULL; n++)
+	continue;
+    }
+  return pf;
+}
+
+/* Output function for compiled formats, copying straight into the
+   buffer when the text fits.  Most pieces are a few bytes long, too
+   short to be worth a call to memcpy.  */
+static int
+__sfputs_compiled (struct _reent *ptr,
+       FILE *fp,
+       const char *buf,
+       size_t len)
+{
+  if (fp->_w > 0 && len <= (size_t) fp->_w
+#ifdef __SCLE
+      && !(fp->_flags & __SCLE)
+#endif
+      )
+    {
+      unsigned char *p = fp->_p;
+
+      fp->_p += len;
+      fp->_w -= len;
+      if (len > 16)
+	memcpy (p, buf, len);
+      else
+	while (len-- > 0)
+	  *p++ = *buf++;
+      return 0;
+    }
+  for (; len > 0; len--, buf++)
+    if (__sputc_r (ptr, (unsigned char) *buf, fp) == EOF)
+      return -1;
+  return 0;
+}
+
+/*
+ * Helper function for unbuffered streams, which would otherwise see
+ * a write for every piece of the output: print into a temporary
+ * buffer as vfprintf does.  We only work on write-only files.
+ *
+ * Make sure to avoid inlining.
+ */
+_NOINLINE_STATIC int
+__sbprintf_compiled (struct _reent *rptr,
+       register FILE *fp,
+       const printf_fmt_t *pf,
+       va_list ap)
+{
+  int ret;
+  FILE fake;
+  unsigned char buf[BUFSIZ];
+
+  /* copy the important variables */
+  fake._flags = fp->_flags & ~__SNBF;
+  fake._flags2 = fp->_flags2;
+  fake._file = fp->_file;
+  fake._cookie = fp->_cookie;
+  fake._write = fp->_write;
+
+  /* set up the buffer */
+  fake._bf._base = fake._p = buf;
+  fake._bf._size = fake._w = sizeof (buf);
+  fake._lbfsize = 0;	/* not actually used, but Just In Case */
+#ifndef __SINGLE_THREAD__
+  __lock_init_recursive (fake._lock);
+#endif
+
+  /* do the work, then copy any error status */
+  ret = _vfprintf_compiled_r (rptr, &fake, pf, ap);
+  if (ret >= 0 && _fflush_r (rptr, &fake))
+    ret = EOF;
+  if (fake._flags & __SERR)
+    fp->_flags |= __SERR;
+
+#ifndef __SINGLE_THREAD__
+  __lock_close_recursive (fake._lock);
+#endif
+  return (ret);
+}
+
+int
+_vfprintf_compiled_r (struct _reent *data,
+       FILE *fp,
+       const printf_fmt_t *pf,
+       va_list ap)
+{
+  const struct _prt_spec_t *spec;
+  struct _prt_data_t prt_data;
+  va_list ap_copy;
+  int n;
+  int (*pfunc)(struct _reent *, FILE *, const char *, size_t len);
+
+  if (pf->nspec < 0)
+    return _vfprintf_r (data, fp, pf->fmt, ap);
+
+  pfunc = __sfputs_compiled;
+
+  CHECK_INIT (data, fp);
+  _newlib_flockfile_start (fp);
+
+  ORIENT (fp, -1);
+
+  /* Sorry, fprintf(read_only_file, "") returns EOF, not 0.  */
+  if (cantwrite (data, fp))
+    {
+      _newlib_flockfile_exit (fp);
+      return (EOF);
+    }
+
+  if ((fp->_flags & (__SNBF|__SWR|__SRW)) == (__SNBF|__SWR) &&
+      fp->_file >= 0)
+    {
+      _newlib_flockfile_exit (fp);
+      return (__sbprintf_compiled (data, fp, pf, ap));
+    }
+
+  prt_data.ret = 0;
+  prt_data.blank = ' ';
+  prt_data.zero = '0';
+
+  va_copy (ap_copy, ap);
+
+  for (spec = pf->spec; ; spec++)
+    {
+      if (spec->litlen != 0)
+	{
+	  PRINT (spec->lit, spec->litlen);
+	  prt_data.ret += spec->litlen;
+	}
+      if (spec->code == '\0')
+	break;
+
+      n = _printf_conv (data, &prt_data, spec, fp, pfunc, &ap_copy);
+      if (n == -1)
+	goto error;
+
+      prt_data.ret += n;
+    }
+error:
+  _newlib_flockfile_end (fp);
+  va_end (ap_copy);
+  return (__sferror (fp) ? EOF : prt_data.ret);
+}
+
+#ifndef _REENT_ONLY
+
+printf_fmt_t *
+printf_compile (const char *fmt)
+{
+  return _printf_compile_r (_REENT, fmt);
+}
+
+int
+vfprintf_compiled (FILE *fp,
+       const printf_fmt_t *pf,
+       va_list ap)
+{
+  return _vfprintf_compiled_r (_REENT, fp, pf, ap);
+}
+
+int
+fprintf_compiled (FILE *fp,
+       const printf_fmt_t *pf,
+       ...)
+{
+  int ret;
+  va_list ap;
+
+  va_start (ap, pf);
+  ret = _vfprintf_compiled_r (_REENT, fp, pf, ap);
+  va_end (ap);
+  return ret;
+}
+
+#endif /* !_REENT_ONLY */
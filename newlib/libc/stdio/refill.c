@@ -113,6 +113,11 @@ __srefill_r (struct _reent * ptr,
 	__sflush_r (ptr, fp);
     }
 
+  /* The last read filled the whole buffer and it has all been used:
+     read more at a time.  */
+  if (fp->_p == fp->_bf._base + fp->_bf._size)
+    __sgrowbuf_r (ptr, fp);
+
   fp->_p = fp->_bf._base;
   fp->_r = fp->_read (ptr, fp->_cookie, (char *) fp->_p, fp->_bf._size);
 #ifndef __CYGWIN__
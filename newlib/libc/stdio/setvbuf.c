@@ -124,6 +124,7 @@ setvbuf (register FILE * fp,
   if (fp->_flags & __SMBF)
     _free_r (reent, (void *) fp->_bf._base);
   fp->_flags &= ~(__SLBF | __SNBF | __SMBF | __SOPT | __SNPT | __SEOF);
+  fp->_flags2 &= ~__SSEQ;
 
   if (mode == _IONBF)
     goto nbf;
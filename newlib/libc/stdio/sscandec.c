@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 1990 The Regents of the University of California.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms are permitted
+ * provided that the above copyright notice and this paragraph are
+ * duplicated in all such forms and that any documentation,
+ * and/or other materials related to such
+ * distribution and use acknowledge that the software was developed
+ * by the University of California, Berkeley.  The name of the
+ * University may not be used to endorse or promote products derived
+ * from this software without specific prior written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Fast path for the integer conversions of vfscanf.c and
+   nano-vfscanf_i.c.  */
+
+#include <_ansi.h>
+#include <reent.h>
+#include <newlib.h>
+#include <stdio.h>
+#include <limits.h>
+#include "local.h"
+
+/*
+ * Scan a decimal integer, as %d (or, if UNS is set, %u) with field
+ * width WIDTH (0 for none) would, straight out of the stream buffer.
+ * This only works when the number is known to end within the buffered
+ * data, and when its value fits in a long (unsigned long if UNS) so
+ * that strtol or strtoul would not have to clamp it.  Then the number
+ * is consumed, its value stored in *RES, and its length in characters
+ * returned.  Otherwise nothing is consumed and 0 is returned, so that
+ * the caller can scan the number the slow way.
+ */
+
+int
+__sscandec (FILE *fp,
+       size_t width,
+       int uns,
+       u_long *res)
+{
+  const u_char *s = fp->_p;
+  const u_char *p = s;
+  const u_char *end;
+  u_long v = 0;
+  u_long max;
+  int neg = 0;
+  int bounded;
+
+  if (fp->_r <= 0)
+    return 0;
+  bounded = width != 0 && width < (size_t) fp->_r;
+  end = s + (bounded ? width : (size_t) fp->_r);
+
+  /* A string being scanned by sscanf has nothing after its buffer. */
+  if ((fp->_flags & __SSTR) && !HASUB (fp))
+    bounded = 1;
+
+  if (*p == '-' || *p == '+')
+    neg = *p++ == '-';
+  if (p == end || *p < '0' || *p > '9')
+    return 0;
+  max = uns ? ULONG_MAX : (u_long) LONG_MAX + neg;
+  do
+    {
+      unsigned d = *p - '0';
+
+      if (v > (max - d) / 10)
+	return 0;
+      v = v * 10 + d;
+    }
+  while (++p < end && *p >= '0' && *p <= '9');
+  if (p == end && !bounded)
+    return 0;
+
+  *res = neg ? -v : v;
+  fp->_r -= p - s;
+  fp->_p = (u_char *) p;
+  return p - s;
+}
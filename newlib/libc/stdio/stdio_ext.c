@@ -1,6 +1,6 @@
 /*
 FUNCTION
-<<stdio_ext>>,<<__fbufsize>>,<<__fpending>>,<<__flbf>>,<<__freadable>>,<<__fwritable>>,<<__freading>>,<<__fwriting>>---access internals of FILE structure
+<<stdio_ext>>,<<__fbufsize>>,<<__fpending>>,<<__flbf>>,<<__freadable>>,<<__fwritable>>,<<__freading>>,<<__fwriting>>,<<__fdirectcount>>---access internals of FILE structure
 
 INDEX
 	__fbufsize
@@ -16,6 +16,8 @@ INDEX
 	__freading
 INDEX
 	__fwriting
+INDEX
+	__fdirectcount
 
 SYNOPSIS
 	#include <stdio.h>
@@ -27,6 +29,7 @@ SYNOPSIS
 	int __fwritable(FILE *<[fp]>);
 	int __freading(FILE *<[fp]>);
 	int __fwriting(FILE *<[fp]>);
+	unsigned long __fdirectcount(void);
 
 DESCRIPTION
 These functions provides access to the internals of the FILE structure <[fp]>.
@@ -48,8 +51,17 @@ it was a read, or if it read-only, and <<0>> if not.
 <<__fwriting>> returns nonzero if stream <[fp]> if the last operation on
 it was a write, or if it write-only, and <<0>> if not.
 
+<<__fdirectcount>> returns the number of times so far that data has
+moved straight between the caller's memory and the file, without
+copying it through a stream buffer.  Input is counted for <<fread>>.
+Output is counted for any write that hands the stream a block of data,
+such as <<fwrite>>, <<fputs>>, <<puts>> or the <<printf>> family.  This
+happens on unbuffered streams, and for requests of at least a
+bufferful.
+
 PORTABILITY
-These functions originate from Solaris and are also provided by GNU libc.
+These functions originate from Solaris and are also provided by GNU libc,
+except for <<__fdirectcount>>, which is a newlib extension.
 
 No supporting OS subroutines are required.
 */
@@ -58,6 +70,7 @@ No supporting OS subroutines are required.
 
 #include <_ansi.h>
 #include <stdio.h>
+#include "local.h"
 
 /* Subroutine versions of the inline or macro functions. */
 
@@ -103,4 +116,10 @@ __fwriting (FILE * fp)
   return (fp->_flags & __SWR) != 0;
 }
 
+unsigned long
+__fdirectcount (void)
+{
+  return __sdirect_count;
+}
+
 #endif /* __rtems__ */
@@ -6,10 +6,13 @@ INDEX
 	tmpfile
 INDEX
 	_tmpfile_r
+INDEX
+	tmpfile_memmax
 
 SYNOPSIS
 	#include <stdio.h>
 	FILE *tmpfile(void);
+	size_t tmpfile_memmax(size_t <[size]>);
 
 	FILE *_tmpfile_r(struct _reent *<[reent]>);
 
@@ -20,6 +23,15 @@ the mode <<"wb+">>, permitting you to read and write anywhere in it
 as a binary file (without any data transformations the host system may
 perform for text files).
 
+The file is first kept in memory, and only written to a real file
+once it would grow past a limit, or once its descriptor is asked for
+with <<fileno>>; until then no file is created at all.  The move is
+invisible to the program: the position, contents and mode of the
+stream are unchanged.  <<tmpfile_memmax>> sets the limit, in bytes,
+for files opened after the call, and returns the previous limit.  A
+limit of 0 makes <<tmpfile>> create the file at once.  The default
+is <<_TMPFILE_MEM_MAX>>, 8192 on 16-bit targets and 65536 elsewhere.
+
 The alternate function <<_tmpfile_r>> is a reentrant version.  The
 argument <[reent]> is a pointer to a reentrancy structure.
 
@@ -28,10 +40,14 @@ RETURNS
 temporary file could be created, the result is NULL, and <<errno>>
 records the reason for failure.
 
+<<tmpfile_memmax>> returns the limit in force before the call.
+
 PORTABILITY
 Both ANSI C and the System V Interface Definition (Issue 2) require
 <<tmpfile>>.
 
+<<tmpfile_memmax>> is a newlib extension.
+
 Supporting OS subroutines required: <<close>>, <<fstat>>, <<getpid>>,
 <<isatty>>, <<lseek>>, <<open>>, <<read>>, <<sbrk>>, <<write>>.
 
@@ -41,18 +57,43 @@ Supporting OS subroutines required: <<close>>, <<fstat>>, <<getpid>>,
 #include <_ansi.h>
 #include <reent.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/lock.h>
+#include "local.h"
 
 #ifndef O_BINARY
 # define O_BINARY 0
 #endif
 
-FILE *
-_tmpfile_r (struct _reent *ptr)
+#ifndef _TMPFILE_MEM_MAX
+# if __INT_MAX__ <= 32767
+#  define _TMPFILE_MEM_MAX 8192
+# else
+#  define _TMPFILE_MEM_MAX 65536
+# endif
+#endif
+
+static size_t tmpfile_mem_max = _TMPFILE_MEM_MAX;
+
+/* Describe a temporary file still held in memory.  */
+typedef struct tmpcookie {
+  int (*spill) (struct _reent *, FILE *); /* must be first, see local.h */
+  FILE *fp; /* the stream */
+  char *buf; /* contents */
+  size_t pos; /* current position */
+  size_t eof; /* current file size */
+  size_t size; /* allocated size of buf */
+  size_t max; /* largest size kept in memory */
+} tmpcookie;
+
+/* Create and open a new temporary file, already unlinked.  */
+static int
+tmpopen (struct _reent *ptr)
 {
-  FILE *fp;
   int e;
   char *f;
   char buf[L_tmpnam];
@@ -61,22 +102,229 @@ _tmpfile_r (struct _reent *ptr)
   do
     {
       if ((f = _tmpnam_r (ptr, buf)) == NULL)
-	return NULL;
+	return -1;
       fd = _open_r (ptr, f, O_RDWR | O_CREAT | O_EXCL | O_BINARY,
 		    S_IRUSR | S_IWUSR);
     }
   while (fd < 0 && ptr->_errno == EEXIST);
   if (fd < 0)
+    return -1;
+  e = ptr->_errno;
+  (void) _remove_r (ptr, f);
+  ptr->_errno = e;
+  return fd;
+}
+
+/* Move the contents of memory-backed stream FP to a real file, and
+   turn FP into an ordinary file stream.  Return 0, or -1 with errno
+   set and FP left in memory.  */
+static int
+tmpspill (struct _reent *ptr,
+       FILE *fp)
+{
+  tmpcookie *c = (tmpcookie *) fp->_cookie;
+  size_t done;
+  _READ_WRITE_RETURN_TYPE n;
+  int fd, e;
+
+  if ((fd = tmpopen (ptr)) < 0)
+    return -1;
+  for (done = 0; done < c->eof; done += n)
+    if ((n = _write_r (ptr, fd, c->buf + done, c->eof - done)) <= 0)
+      goto fail;
+  if (_lseek_r (ptr, fd, (_off_t) c->pos, SEEK_SET) < 0)
+    goto fail;
+
+  fp->_file = fd;
+  fp->_cookie = (void *) fp;
+  fp->_read = __sread;
+  fp->_write = __swrite;
+  fp->_seek = __sseek;
+  fp->_close = __sclose;
+  fp->_flags &= ~__SOFF;
+  fp->_flags2 &= ~__SMTMP;
+  _free_r (ptr, c->buf);
+  _free_r (ptr, c);
+  return 0;
+
+fail:
+  e = ptr->_errno;
+  _close_r (ptr, fd);
+  ptr->_errno = e;
+  return -1;
+}
+
+/* Read up to N bytes into BUF from the stream described by COOKIE;
+   return the number of bytes read (0 on EOF).  */
+static _READ_WRITE_RETURN_TYPE
+tmpreader (struct _reent *ptr,
+       void *cookie,
+       char *buf,
+       _READ_WRITE_BUFSIZE_TYPE n)
+{
+  tmpcookie *c = (tmpcookie *) cookie;
+
+  if (c->pos >= c->eof)
+    return 0;
+  if ((size_t) n > c->eof - c->pos)
+    n = c->eof - c->pos;
+  memcpy (buf, c->buf + c->pos, n);
+  c->pos += n;
+  return n;
+}
+
+/* Write N bytes of BUF to the stream described by COOKIE, moving it to
+   a real file first if it would grow past its limit.  */
+static _READ_WRITE_RETURN_TYPE
+tmpwriter (struct _reent *ptr,
+       void *cookie,
+       const char *buf,
+       _READ_WRITE_BUFSIZE_TYPE n)
+{
+  tmpcookie *c = (tmpcookie *) cookie;
+  FILE *fp = c->fp;
+  size_t end;
+
+  if ((size_t) n > c->max - c->pos)
+    goto spill;
+  end = c->pos + n;
+  if (end > c->size)
+    {
+      /* Grow geometrically, but not past the limit.  */
+      size_t newsize = c->size < c->max / 2 ? c->size * 2 : c->max;
+      char *newbuf;
+
+      if (newsize < end)
+	newsize = end;
+      if (newsize < 64 && c->max >= 64)
+	newsize = 64;
+      newbuf = (char *) _realloc_r (ptr, c->buf, newsize);
+      if (newbuf == NULL)
+	goto spill;
+      c->buf = newbuf;
+      c->size = newsize;
+    }
+  /* Bytes skipped by a seek past the end read back as zeros.  */
+  if (c->pos > c->eof)
+    memset (c->buf + c->eof, '\0', c->pos - c->eof);
+  memcpy (c->buf + c->pos, buf, n);
+  c->pos = end;
+  if (end > c->eof)
+    c->eof = end;
+  return n;
+
+spill:
+  if (tmpspill (ptr, fp) < 0)
+    return -1;
+  return fp->_write (ptr, fp->_cookie, buf, n);
+}
+
+/* Seek to position POS relative to WHENCE within the stream described
+   by COOKIE; return the resulting position, or -1.  */
+static _fpos_t
+tmpseeker (struct _reent *ptr,
+       void *cookie,
+       _fpos_t pos,
+       int whence)
+{
+  tmpcookie *c = (tmpcookie *) cookie;
+  FILE *fp = c->fp;
+  _fpos_t offset = pos;
+
+  if (whence == SEEK_CUR)
+    offset += c->pos;
+  else if (whence == SEEK_END)
+    offset += c->eof;
+  if (offset < 0)
+    {
+      ptr->_errno = EINVAL;
+      return -1;
+    }
+  if (offset > (_fpos_t) c->max)
+    {
+      /* Too far out to hold in memory.  */
+      if (tmpspill (ptr, fp) < 0)
+	return -1;
+      return fp->_seek (ptr, fp->_cookie, offset, SEEK_SET);
+    }
+  c->pos = (size_t) offset;
+  return offset;
+}
+
+static int
+tmpcloser (struct _reent *ptr,
+       void *cookie)
+{
+  tmpcookie *c = (tmpcookie *) cookie;
+
+  _free_r (ptr, c->buf);
+  _free_r (ptr, c);
+  return 0;
+}
+
+FILE *
+_tmpfile_r (struct _reent *ptr)
+{
+  FILE *fp;
+  tmpcookie *c;
+  int e;
+  int fd;
+
+  if (tmpfile_mem_max != 0)
+    {
+      if ((fp = __sfp (ptr)) == NULL)
+	return NULL;
+      if ((c = (tmpcookie *) _malloc_r (ptr, sizeof *c)) == NULL)
+	{
+	  _newlib_sfp_lock_start ();
+	  __sfp_release (fp);		/* release */
+#ifndef __SINGLE_THREAD__
+	  __lock_close_recursive (fp->_lock);
+#endif
+	  _newlib_sfp_lock_end ();
+	  return NULL;
+	}
+
+      _newlib_flockfile_start (fp);
+      c->spill = tmpspill;
+      c->fp = fp;
+      c->buf = NULL;
+      c->pos = c->eof = c->size = 0;
+      c->max = tmpfile_mem_max;
+      fp->_file = -1;
+      fp->_flags = __SRW;
+      fp->_flags2 |= __SMTMP;
+      fp->_cookie = c;
+      fp->_read = tmpreader;
+      fp->_write = tmpwriter;
+      fp->_seek = tmpseeker;
+#ifdef __LARGE64_FILES
+      fp->_seek64 = NULL;
+#endif
+      fp->_close = tmpcloser;
+      _newlib_flockfile_end (fp);
+      return fp;
+    }
+
+  if ((fd = tmpopen (ptr)) < 0)
     return NULL;
   fp = _fdopen_r (ptr, fd, "wb+");
   e = ptr->_errno;
   if (!fp)
     _close_r (ptr, fd);
-  (void) _remove_r (ptr, f);
   ptr->_errno = e;
   return fp;
 }
 
+size_t
+tmpfile_memmax (size_t size)
+{
+  size_t old = tmpfile_mem_max;
+
+  tmpfile_mem_max = size;
+  return old;
+}
+
 #ifndef _REENT_ONLY
 
 FILE *
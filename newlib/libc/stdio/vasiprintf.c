@@ -25,9 +25,16 @@ static char sccsid[] = "%W% (Berkeley) %G%";
 #include <stdio.h>
 #include <limits.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "local.h"
 
+/* Size of the buffer on the stack that output starts out in.  */
+#ifndef _ASPRINTF_STACK_SIZE
+#define _ASPRINTF_STACK_SIZE 64
+#endif
+
 #ifndef _REENT_ONLY
 
 int
@@ -48,16 +55,34 @@ _vasiprintf_r (struct _reent *ptr,
 {
   int ret;
   FILE f;
+  char buf[_ASPRINTF_STACK_SIZE];
+  char *str;
 
-  f._flags = __SWR | __SSTR | __SMBF ;
-  f._bf._base = f._p = NULL;
-  f._bf._size = f._w = 0;
+  /* Start out on the stack; like asnprintf, move to the heap only when
+     the output outgrows BUF.  */
+  f._flags = __SWR | __SSTR | __SOPT;
+  f._bf._base = f._p = (unsigned char *) buf;
+  f._bf._size = f._w = sizeof (buf);
   f._file = -1;  /* No file. */
   ret = _svfiprintf_r (ptr, &f, fmt, ap);
   if (ret >= 0)
     {
       *f._p = 0;
-      *strp = (char *) f._bf._base;
+      if (f._flags & __SOPT)
+	{
+	  str = (char *) _malloc_r (ptr, (size_t) ret + 1);
+	  if (str == NULL)
+	    return -1;
+	  memcpy (str, buf, (size_t) ret + 1);
+	}
+      else
+	{
+	  /* Give back what growing the buffer overallocated.  */
+	  str = (char *) _realloc_r (ptr, f._bf._base, (size_t) ret + 1);
+	  if (str == NULL)
+	    str = (char *) f._bf._base;
+	}
+      *strp = str;
     }
   return ret;
 }
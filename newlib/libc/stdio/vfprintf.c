@@ -371,13 +371,9 @@ __sfputs_r (struct _reent *ptr,
 
 #ifdef _WIDE_ORIENT
 	if (fp->_flags2 & __SWID) {
-		wchar_t *p;
-
-		p = (wchar_t *) buf;
-		for (i = 0; i < (len / sizeof (wchar_t)); i++) {
-			if (_fputwc_r (ptr, p[i], fp) == WEOF)
-				return -1;
-		}
+		if (__fputwcs (ptr, (wchar_t *) buf,
+			       len / sizeof (wchar_t), fp) != 0)
+			return -1;
 	} else {
 #else
 	{
@@ -408,19 +404,16 @@ __sprint_r (struct _reent *ptr,
 #ifdef _WIDE_ORIENT
 	if (fp->_flags2 & __SWID) {
 		struct __siov *iov;
-		wchar_t *p;
-		int i, len;
+		int len;
 
 		iov = uio->uio_iov;
 		for (; uio->uio_resid != 0;
 		     uio->uio_resid -= len * sizeof (wchar_t), iov++) {
-			p = (wchar_t *) iov->iov_base;
 			len = iov->iov_len / sizeof (wchar_t);
-			for (i = 0; i < len; i++) {
-				if (_fputwc_r (ptr, p[i], fp) == WEOF) {
-					err = -1;
-					goto out;
-				}
+			if (__fputwcs (ptr, (wchar_t *) iov->iov_base,
+				       len, fp) != 0) {
+				err = -1;
+				goto out;
 			}
 		}
 	} else
@@ -575,6 +568,10 @@ typedef short *  short_ptr_t;
 #  define MAX_POS_ARGS 32
 # endif
 
+/* get_arg notes where each conversion it scans starts and ends, so that
+   the text between them need not be scanned again.  */
+# define MAX_FMT_MARKS 32
+
 union arg_val
 {
   int val_int;
@@ -597,8 +594,9 @@ union arg_val
 
 static union arg_val *
 get_arg (struct _reent *data, int n, char *fmt,
-                 va_list *ap, int *numargs, union arg_val *args,
-                 int *arg_type, char **last_fmt);
+                 va_list ap, int *numargs, union arg_val *args,
+                 int *arg_type, char **last_fmt,
+                 char **marks, int *nmarks);
 #endif /* !_NO_POS_ARGS */
 
 /*
@@ -670,6 +668,9 @@ _VFPRINTF_R (struct _reent *data,
 	int arg_type[MAX_POS_ARGS];
 	int is_pos_arg;         /* is current format positional? */
 	int old_is_pos_arg;     /* is current format positional? */
+	char *fmt_marks[MAX_FMT_MARKS]; /* conversion starts and ends */
+	int nmarks;             /* number of fmt_marks set by get_arg */
+	int mark;               /* fmt_marks index of the next end */
 #endif
 	int ret;		/* return value accumulator */
 	int width;		/* width from format (%8d), or 0 */
@@ -802,8 +803,8 @@ _VFPRINTF_R (struct _reent *data,
 	(is_pos_arg							\
 	 ? (n < numargs							\
 	    ? args[n].val_##type					\
-	    : get_arg (data, n, fmt_anchor, &ap, &numargs, args,	\
-		       arg_type, &saved_fmt)->val_##type)		\
+	    : get_arg (data, n, fmt_anchor, ap, &numargs, args,	\
+		       arg_type, &saved_fmt, fmt_marks, &nmarks)->val_##type) \
 	 : (arg_index++ < numargs					\
 	    ? args[n].val_##type					\
 	    : (numargs < MAX_POS_ARGS					\
@@ -888,9 +889,10 @@ _VFPRINTF_R (struct _reent *data,
 #ifndef _NO_POS_ARGS
 	arg_index = 0;
 	saved_fmt = NULL;
-	arg_type[0] = -1;
 	numargs = 0;
 	is_pos_arg = 0;
+	nmarks = 0;
+	mark = 1;
 #endif
 
 	/*
@@ -898,6 +900,19 @@ _VFPRINTF_R (struct _reent *data,
 	 */
 	for (;;) {
 	        cp = fmt;
+#ifndef _NO_POS_ARGS
+		/* Once get_arg has scanned the format, skip straight to the
+		   next conversion, unless we parsed this one differently.  */
+		if (mark + 1 < nmarks && fmt == fmt_marks[mark]) {
+			fmt = fmt_marks[mark + 1];
+			mark += 2;
+#ifdef _MB_CAPABLE
+			memset (&state, 0, sizeof state);
+			n = *fmt != '\0';
+#endif
+		} else {
+			nmarks = 0;
+#endif
 #ifdef _MB_CAPABLE
 	        while ((n = __MBTOWC (data, &wc, fmt, MB_CUR_MAX,
 				      &state)) != 0) {
@@ -913,6 +928,9 @@ _VFPRINTF_R (struct _reent *data,
 #else
                 while (*fmt != '\0' && *fmt != '%')
                     fmt += 1;
+#endif
+#ifndef _NO_POS_ARGS
+		}
 #endif
 		if ((m = fmt - cp) != 0) {
 			PRINT (cp, m);
@@ -2002,7 +2020,7 @@ const __STATE __state_table[MAX_STATE][MAX_CH_CLASS] = {
   /*             '0'     '1-9'     '$'     MODFR    SPEC    '.'     '*'    FLAG    OTHER */
   /* START */  { SFLAG,   WDIG,    DONE,   SMOD,    DONE,   SDOT,  VARW,   SFLAG,  DONE },
   /* SFLAG */  { SFLAG,   WDIG,    DONE,   SMOD,    DONE,   SDOT,  VARW,   SFLAG,  DONE },
-  /* WDIG  */  { DONE,    DONE,    WIDTH,  SMOD,    DONE,   SDOT,  DONE,   DONE,   DONE },
+  /* WDIG  */  { DONE,    DONE,    SFLAG,  SMOD,    DONE,   SDOT,  DONE,   DONE,   DONE },
   /* WIDTH */  { DONE,    DONE,    DONE,   SMOD,    DONE,   SDOT,  DONE,   DONE,   DONE },
   /* SMOD  */  { DONE,    DONE,    DONE,   DONE,    DONE,   DONE,  DONE,   DONE,   DONE },
   /* SDOT  */  { SDOT,    PREC,    DONE,   SMOD,    DONE,   DONE,  VARP,   DONE,   DONE },
@@ -2030,16 +2048,29 @@ const __ACTION __action_table[MAX_STATE][MAX_CH_CLASS] = {
 
 #endif /* STRING_ONLY && INTEGER_ONLY */
 
-/* function to get positional parameter N where n = N - 1 */
+/*
+ * Function to get positional parameter N where n = N - 1.
+ *
+ * The first call, made at the first conversion that names its argument,
+ * scans the rest of the format once, noting the type of every argument
+ * it refers to, and then reads all of them from AP into ARGS.  Every
+ * later positional argument is taken from ARGS directly.  The caller
+ * must not use AP after this.
+ *
+ * MARKS gets the start and end of each conversion seen, starting with
+ * the one at FMT, and then the end of the format.
+ */
 static union arg_val *
 get_arg (struct _reent *data,
        int n,
        char *fmt,
-       va_list *ap,
+       va_list ap,
        int *numargs_p,
        union arg_val *args,
        int *arg_type,
-       char **last_fmt)
+       char **last_fmt,
+       char **marks,
+       int *nmarks)
 {
   int ch;
   int number, flags;
@@ -2048,7 +2079,7 @@ get_arg (struct _reent *data,
   __CH_CLASS chtype;
   __STATE state, next_state;
   __ACTION action;
-  int pos, last_arg;
+  int pos;
   int max_pos_arg = n;
   /* Only need types that can be reached via vararg promotions.  */
   enum types { INT, LONG_INT, QUAD_INT, CHAR_PTR, DOUBLE, LONG_DOUBLE, WIDE_CHAR };
@@ -2058,32 +2089,55 @@ get_arg (struct _reent *data,
   int nbytes;
 # endif
 
-  /* if this isn't the first call, pick up where we left off last time */
+  /* The table is complete after the first call; only a conversion the
+     scan below did not see can ask again.  There is nothing left to read
+     for it.  */
   if (*last_fmt != NULL)
-    fmt = *last_fmt;
+    {
+      if (n >= numargs)
+	{
+	  memset (&args[numargs], 0, (n + 1 - numargs) * sizeof (*args));
+	  *numargs_p = n + 1;
+	}
+      return &args[n];
+    }
 
 # ifdef _MB_CAPABLE
   memset (&wc_state, '\0', sizeof (wc_state));
 # endif
 
-  /* we need to process either to end of fmt string or until we have actually
-     read the desired parameter from the vararg list. */
-  while (*fmt && n >= numargs)
+  /* arguments not given a type below are ints */
+  for (pos = numargs; pos <= n; pos++)
+    arg_type[pos] = INT;
+
+  /* process to the end of the fmt string */
+  while (*fmt)
     {
 # ifdef _MB_CAPABLE
-      while ((nbytes = __MBTOWC (data, &wc, fmt, MB_CUR_MAX, &wc_state)) > 0)
+      while ((nbytes = __MBTOWC (data, &wc, fmt, MB_CUR_MAX, &wc_state)) != 0)
 	{
+	  if (nbytes < 0)
+	    {
+	      /* Wave invalid chars through, as the caller does.  */
+	      memset (&wc_state, 0, sizeof wc_state);
+	      fmt += 1;
+	      continue;
+	    }
 	  fmt += nbytes;
 	  if (wc == '%')
 	    break;
 	}
 
-      if (nbytes <= 0)
+      if (*nmarks < MAX_FMT_MARKS)
+	marks[(*nmarks)++] = nbytes == 0 ? fmt : fmt - 1;
+      if (nbytes == 0)
 	break;
 # else
       while (*fmt != '\0' && *fmt != '%')
 	fmt += 1;
 
+      if (*nmarks < MAX_FMT_MARKS)
+	marks[(*nmarks)++] = fmt;
       if (*fmt == '\0')
 	break;
 
@@ -2100,7 +2154,7 @@ get_arg (struct _reent *data,
          read the vararg list. */
       while (state != DONE)
 	{
-	  ch = *fmt++;
+	  ch = (unsigned char) *fmt++;
 	  chtype = __chclass[ch];
 	  next_state = __state_table[state][chtype];
 	  action = __action_table[state][chtype];
@@ -2241,48 +2295,50 @@ get_arg (struct _reent *data,
 		    switch (spec_type)
 		      {
 		      case LONG_INT:
-			args[numargs++].val_long = va_arg (*ap, long);
+			args[numargs++].val_long = va_arg (ap, long);
 			break;
 		      case QUAD_INT:
-			args[numargs++].val_quad_t = va_arg (*ap, quad_t);
+			args[numargs++].val_quad_t = va_arg (ap, quad_t);
 			break;
 		      case WIDE_CHAR:
-			args[numargs++].val_wint_t = va_arg (*ap, wint_t);
+			args[numargs++].val_wint_t = va_arg (ap, wint_t);
 			break;
 		      case INT:
-			args[numargs++].val_int = va_arg (*ap, int);
+			args[numargs++].val_int = va_arg (ap, int);
 			break;
 		      case CHAR_PTR:
-			args[numargs++].val_char_ptr_t = va_arg (*ap, char *);
+			args[numargs++].val_char_ptr_t = va_arg (ap, char *);
 			break;
 		      case DOUBLE:
-			args[numargs++].val_double = va_arg (*ap, double);
+			args[numargs++].val_double = va_arg (ap, double);
 			break;
 		      case LONG_DOUBLE:
-			args[numargs++].val__LONG_DOUBLE = va_arg (*ap, _LONG_DOUBLE);
+			args[numargs++].val__LONG_DOUBLE = va_arg (ap, _LONG_DOUBLE);
 			break;
 		      }
 		  }
 	      }
 	      break;
 	    case GETPOS: /* we have positional specifier */
-	      if (arg_type[0] == -1)
-		memset (arg_type, 0, sizeof (int) * MAX_POS_ARGS);
+	      if (number > MAX_POS_ARGS)
+		goto scanned;	/* the caller stops here with an error */
 	      pos = number - 1;
-	      max_pos_arg = (max_pos_arg > pos ? max_pos_arg : pos);
+	      while (max_pos_arg < pos)
+		arg_type[++max_pos_arg] = INT;
 	      break;
 	    case PWPOS:  /* we have positional specifier for width or precision */
-	      if (arg_type[0] == -1)
-		memset (arg_type, 0, sizeof (int) * MAX_POS_ARGS);
+	      if (number > MAX_POS_ARGS)
+		goto scanned;
 	      number -= 1;
+	      while (max_pos_arg < number)
+		arg_type[++max_pos_arg] = INT;
 	      arg_type[number] = INT;
-	      max_pos_arg = (max_pos_arg > number ? max_pos_arg : number);
 	      break;
 	    case GETPWB: /* we require format pushback */
 	      --fmt;
 	      /* fallthrough */
 	    case GETPW:  /* we have a variable precision or width to acquire */
-	      args[numargs++].val_int = va_arg (*ap, int);
+	      args[numargs++].val_int = va_arg (ap, int);
 	      break;
 	    case NUMBER: /* we have a number to process */
 	      number = (ch - '0');
@@ -2301,46 +2357,42 @@ get_arg (struct _reent *data,
 	      break; /* do nothing */
 	    }
 	}
+      if (*nmarks < MAX_FMT_MARKS)
+	marks[(*nmarks)++] = fmt;
     }
 
-  /* process all arguments up to at least the one we are looking for and if we
-     have seen the end of the string, then process up to the max argument needed */
-  if (*fmt == '\0')
-    last_arg = max_pos_arg;
-  else
-    last_arg = n;
-
-  while (numargs <= last_arg)
+scanned:
+  /* now read every argument up to the last one needed, in order */
+  while (numargs <= max_pos_arg)
     {
       switch (arg_type[numargs])
 	{
 	case LONG_INT:
-	  args[numargs++].val_long = va_arg (*ap, long);
+	  args[numargs++].val_long = va_arg (ap, long);
 	  break;
 	case QUAD_INT:
-	  args[numargs++].val_quad_t = va_arg (*ap, quad_t);
+	  args[numargs++].val_quad_t = va_arg (ap, quad_t);
 	  break;
 	case CHAR_PTR:
-	  args[numargs++].val_char_ptr_t = va_arg (*ap, char *);
+	  args[numargs++].val_char_ptr_t = va_arg (ap, char *);
 	  break;
 	case DOUBLE:
-	  args[numargs++].val_double = va_arg (*ap, double);
+	  args[numargs++].val_double = va_arg (ap, double);
 	  break;
 	case LONG_DOUBLE:
-	  args[numargs++].val__LONG_DOUBLE = va_arg (*ap, _LONG_DOUBLE);
+	  args[numargs++].val__LONG_DOUBLE = va_arg (ap, _LONG_DOUBLE);
 	  break;
 	case WIDE_CHAR:
-	  args[numargs++].val_wint_t = va_arg (*ap, wint_t);
+	  args[numargs++].val_wint_t = va_arg (ap, wint_t);
 	  break;
 	case INT:
 	default:
-	  args[numargs++].val_int = va_arg (*ap, int);
+	  args[numargs++].val_int = va_arg (ap, int);
 	  break;
 	}
     }
 
-  /* alter the global numargs value and keep a reference to the last bit of the fmt
-     string we processed here because the caller will continue processing where we started */
+  /* alter the global numargs value and note that the table is complete */
   *numargs_p = numargs;
   *last_fmt = fmt;
   return &args[n];
@@ -1328,6 +1328,16 @@ __SVFSCANF_R (struct _reent *rptr,
 	  /* scan an integer as if by strtol/strtoul */
 	  unsigned width_left = 0;
 	  int skips = 0;
+	  u_long res = 0;
+
+	  /* Decimal numbers are usually in the buffer whole, and in range:
+	     convert those right there.  */
+	  if (base == 10 && !(flags & LONGDBL)
+	      && (n = __sscandec (fp, width, ccfn == _strtoul_r, &res)) > 0)
+	    {
+	      nread += n;
+	      goto int_done;
+	    }
 #ifdef hardway
 	  if (width == 0 || width > sizeof (buf) - 1)
 #else
@@ -1479,10 +1489,13 @@ __SVFSCANF_R (struct _reent *rptr,
 	    }
 	  if ((flags & SUPPRESS) == 0)
 	    {
-	      u_long res;
-
 	      *p = 0;
 	      res = (*ccfn) (rptr, buf, (char **) NULL, base);
+	    }
+	  nread += p - buf + skips;
+	int_done:
+	  if ((flags & SUPPRESS) == 0)
+	    {
 	      if (flags & POINTER)
 		{
 		  void **vp = GET_ARG (N, ap, void **);
@@ -1533,7 +1546,6 @@ __SVFSCANF_R (struct _reent *rptr,
 		}
 	      nassigned++;
 	    }
-	  nread += p - buf + skips;
 	  break;
 	}
 #ifdef FLOATING_POINT
@@ -189,6 +189,7 @@ __sbwprintf (struct _reent *rptr,
 	fake._file = fp->_file;
 	fake._cookie = fp->_cookie;
 	fake._write = fp->_write;
+	fake._mbstate = fp->_mbstate;
 
 	/* set up the buffer */
 	fake._bf._base = fake._p = buf;
@@ -204,6 +205,7 @@ __sbwprintf (struct _reent *rptr,
 		ret = EOF;
 	if (fake._flags & __SERR)
 		fp->_flags |= __SERR;
+	fp->_mbstate = fake._mbstate;
 
 #ifndef __SINGLE_THREAD__
 	__lock_close_recursive (fake._lock);
@@ -325,7 +327,7 @@ union arg_val
 
 static union arg_val *
 get_arg (struct _reent *data, int n, wchar_t *fmt,
-                 va_list *ap, int *numargs, union arg_val *args,
+                 va_list ap, int *numargs, union arg_val *args,
                  int *arg_type, wchar_t **last_fmt);
 #endif /* !_NO_POS_ARGS */
 
@@ -545,7 +547,7 @@ _VFWPRINTF_R (struct _reent *data,
 	(is_pos_arg							\
 	 ? (n < numargs							\
 	    ? args[n].val_##type					\
-	    : get_arg (data, n, fmt_anchor, &ap, &numargs, args,	\
+	    : get_arg (data, n, fmt_anchor, ap, &numargs, args,	\
 		       arg_type, &saved_fmt)->val_##type)		\
 	 : (arg_index++ < numargs					\
 	    ? args[n].val_##type					\
@@ -631,7 +633,6 @@ _VFWPRINTF_R (struct _reent *data,
 #ifndef _NO_POS_ARGS
 	arg_index = 0;
 	saved_fmt = NULL;
-	arg_type[0] = -1;
 	numargs = 0;
 	is_pos_arg = 0;
 #endif
@@ -1729,12 +1730,20 @@ wexponent(wchar_t *p0, int exp, int fmtch)
    (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
    SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
 
-/* function to get positional parameter N where n = N - 1 */
+/*
+ * Function to get positional parameter N where n = N - 1.
+ *
+ * The first call, made at the first conversion that names its argument,
+ * scans the rest of the format once, noting the type of every argument
+ * it refers to, and then reads all of them from AP into ARGS.  Every
+ * later positional argument is taken from ARGS directly.  The caller
+ * must not use AP after this.
+ */
 static union arg_val *
 get_arg (struct _reent *data,
        int n,
        wchar_t *fmt,
-       va_list *ap,
+       va_list ap,
        int *numargs_p,
        union arg_val *args,
        int *arg_type,
@@ -1747,24 +1756,38 @@ get_arg (struct _reent *data,
   __CH_CLASS chtype;
   __STATE state, next_state;
   __ACTION action;
-  int pos, last_arg;
+  int pos;
   int max_pos_arg = n;
   /* Only need types that can be reached via vararg promotions.  */
   enum types { INT, LONG_INT, QUAD_INT, CHAR_PTR, DOUBLE, LONG_DOUBLE, WIDE_CHAR };
 
-  /* if this isn't the first call, pick up where we left off last time */
+  /* The table is complete after the first call; only a conversion the
+     scan below did not see can ask again.  There is nothing left to read
+     for it.  */
   if (*last_fmt != NULL)
-    fmt = *last_fmt;
+    {
+      if (n >= numargs)
+	{
+	  memset (&args[numargs], 0, (n + 1 - numargs) * sizeof (*args));
+	  *numargs_p = n + 1;
+	}
+      return &args[n];
+    }
+
+  /* arguments not given a type below are ints */
+  for (pos = numargs; pos <= n; pos++)
+    arg_type[pos] = INT;
 
-  /* we need to process either to end of fmt string or until we have actually
-     read the desired parameter from the vararg list. */
-  while (*fmt && n >= numargs)
+  /* process to the end of the fmt string */
+  while (*fmt)
     {
       while (*fmt != L'\0' && *fmt != L'%')
-				fmt += 1;
+	fmt += 1;
 
       if (*fmt == L'\0')
-				break;
+	break;
+
+      fmt++;
       state = START;
       flags = 0;
       pos = -1;
@@ -1912,48 +1935,50 @@ get_arg (struct _reent *data,
 		    switch (spec_type)
 		      {
 		      case LONG_INT:
-			args[numargs++].val_long = va_arg (*ap, long);
+			args[numargs++].val_long = va_arg (ap, long);
 			break;
 		      case QUAD_INT:
-			args[numargs++].val_quad_t = va_arg (*ap, quad_t);
+			args[numargs++].val_quad_t = va_arg (ap, quad_t);
 			break;
 		      case WIDE_CHAR:
-			args[numargs++].val_wint_t = va_arg (*ap, wint_t);
+			args[numargs++].val_wint_t = va_arg (ap, wint_t);
 			break;
 		      case INT:
-			args[numargs++].val_int = va_arg (*ap, int);
+			args[numargs++].val_int = va_arg (ap, int);
 			break;
 		      case CHAR_PTR:
-			args[numargs++].val_wchar_ptr_t = va_arg (*ap, wchar_t *);
+			args[numargs++].val_wchar_ptr_t = va_arg (ap, wchar_t *);
 			break;
 		      case DOUBLE:
-			args[numargs++].val_double = va_arg (*ap, double);
+			args[numargs++].val_double = va_arg (ap, double);
 			break;
 		      case LONG_DOUBLE:
-			args[numargs++].val__LONG_DOUBLE = va_arg (*ap, _LONG_DOUBLE);
+			args[numargs++].val__LONG_DOUBLE = va_arg (ap, _LONG_DOUBLE);
 			break;
 		      }
 		  }
 	      }
 	      break;
 	    case GETPOS: /* we have positional specifier */
-	      if (arg_type[0] == -1)
-		memset (arg_type, 0, sizeof (int) * MAX_POS_ARGS);
+	      if (number > MAX_POS_ARGS)
+		goto scanned;	/* the caller stops here with an error */
 	      pos = number - 1;
-	      max_pos_arg = (max_pos_arg > pos ? max_pos_arg : pos);
+	      while (max_pos_arg < pos)
+		arg_type[++max_pos_arg] = INT;
 	      break;
 	    case PWPOS:  /* we have positional specifier for width or precision */
-	      if (arg_type[0] == -1)
-		memset (arg_type, 0, sizeof (int) * MAX_POS_ARGS);
+	      if (number > MAX_POS_ARGS)
+		goto scanned;
 	      number -= 1;
+	      while (max_pos_arg < number)
+		arg_type[++max_pos_arg] = INT;
 	      arg_type[number] = INT;
-	      max_pos_arg = (max_pos_arg > number ? max_pos_arg : number);
 	      break;
 	    case GETPWB: /* we require format pushback */
 	      --fmt;
 	      /* fallthrough */
 	    case GETPW:  /* we have a variable precision or width to acquire */
-	      args[numargs++].val_int = va_arg (*ap, int);
+	      args[numargs++].val_int = va_arg (ap, int);
 	      break;
 	    case NUMBER: /* we have a number to process */
 	      number = (ch - '0');
@@ -1974,44 +1999,38 @@ get_arg (struct _reent *data,
 	}
     }
 
-  /* process all arguments up to at least the one we are looking for and if we
-     have seen the end of the string, then process up to the max argument needed */
-  if (*fmt == '\0')
-    last_arg = max_pos_arg;
-  else
-    last_arg = n;
-
-  while (numargs <= last_arg)
+scanned:
+  /* now read every argument up to the last one needed, in order */
+  while (numargs <= max_pos_arg)
     {
       switch (arg_type[numargs])
 	{
 	case LONG_INT:
-	  args[numargs++].val_long = va_arg (*ap, long);
+	  args[numargs++].val_long = va_arg (ap, long);
 	  break;
 	case QUAD_INT:
-	  args[numargs++].val_quad_t = va_arg (*ap, quad_t);
+	  args[numargs++].val_quad_t = va_arg (ap, quad_t);
 	  break;
 	case CHAR_PTR:
-	  args[numargs++].val_wchar_ptr_t = va_arg (*ap, wchar_t *);
+	  args[numargs++].val_wchar_ptr_t = va_arg (ap, wchar_t *);
 	  break;
 	case DOUBLE:
-	  args[numargs++].val_double = va_arg (*ap, double);
+	  args[numargs++].val_double = va_arg (ap, double);
 	  break;
 	case LONG_DOUBLE:
-	  args[numargs++].val__LONG_DOUBLE = va_arg (*ap, _LONG_DOUBLE);
+	  args[numargs++].val__LONG_DOUBLE = va_arg (ap, _LONG_DOUBLE);
 	  break;
 	case WIDE_CHAR:
-	  args[numargs++].val_wint_t = va_arg (*ap, wint_t);
+	  args[numargs++].val_wint_t = va_arg (ap, wint_t);
 	  break;
 	case INT:
 	default:
-	  args[numargs++].val_int = va_arg (*ap, int);
+	  args[numargs++].val_int = va_arg (ap, int);
 	  break;
 	}
     }
 
-  /* alter the global numargs value and keep a reference to the last bit of the fmt
-     string we processed here because the caller will continue processing where we started */
+  /* alter the global numargs value and note that the table is complete */
   *numargs_p = numargs;
   *last_fmt = fmt;
   return &args[n];
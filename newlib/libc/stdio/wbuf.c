@@ -73,6 +73,9 @@ __swbuf_r (struct _reent *ptr,
     {
       if (_fflush_r (ptr, fp))
 	return EOF;
+      /* A whole buffer went out: write more at a time from now on.  */
+      if (__sgrowbuf_r (ptr, fp))
+	fp->_w = fp->_bf._size;
       n = 0;
     }
   fp->_w--;
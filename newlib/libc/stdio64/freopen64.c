@@ -117,7 +117,12 @@ _freopen64_r (struct _reent *ptr,
    */
 
   if (fp->_flags == 0)
-    fp->_flags = __SEOF;	/* hold on to it */
+    {
+      __sfp_lock_acquire ();
+      __sfp_reclaim (fp);
+      fp->_flags = __SEOF;	/* hold on to it */
+      __sfp_lock_release ();
+    }
   else
     {
       if (fp->_flags & __SWR)
@@ -147,17 +152,28 @@ _freopen64_r (struct _reent *ptr,
       /*
        * Reuse the file descriptor, but only if the new access mode is
        * equal or less permissive than the old.  F_SETFL correctly
-       * ignores creation flags.
+       * ignores creation flags.  A tmpfile still in memory has to be
+       * given one first.
        */
-      f = fp->_file;
-      if ((oldflags = _fcntl_r (ptr, f, F_GETFL, 0)) == -1
-	  || ! ((oldflags & O_ACCMODE) == O_RDWR
-		|| ((oldflags ^ oflags) & O_ACCMODE) == 0)
-	  || _fcntl_r (ptr, f, F_SETFL, oflags) == -1)
-	f = -1;
+      e = EBADF;
+      if ((fp->_flags2 & __SMTMP) && __smtmpspill (ptr, fp) < 0)
+	{
+	  f = -1;
+	  e = ptr->_errno;
+	}
+      else
+	{
+	  f = fp->_file;
+	  if ((oldflags = _fcntl_r (ptr, f, F_GETFL, 0)) == -1
+	      || ! ((oldflags & O_ACCMODE) == O_RDWR
+		    || ((oldflags ^ oflags) & O_ACCMODE) == 0)
+	      || _fcntl_r (ptr, f, F_SETFL, oflags) == -1)
+	    f = -1;
+	}
 #else
       /* We cannot modify without fcntl support.  */
       f = -1;
+      e = EBADF;
 #endif
 
 #ifdef __SCLE
@@ -171,7 +187,6 @@ _freopen64_r (struct _reent *ptr,
 
       if (f < 0)
 	{
-	  e = EBADF;
 	  if (fp->_close != NULL)
 	    fp->_close (ptr, fp->_cookie);
 	}
@@ -199,13 +214,13 @@ _freopen64_r (struct _reent *ptr,
     FREELB (ptr, fp);
   fp->_lb._size = 0;
   fp->_flags &= ~__SORD;
-  fp->_flags2 &= ~__SWID;
+  fp->_flags2 &= ~(__SWID | __SMTMP | __SSEQ);
   memset (&fp->_mbstate, 0, sizeof (_mbstate_t));
 
   if (f < 0)
     {				/* did not get it after all */
       __sfp_lock_acquire ();
-      fp->_flags = 0;		/* set it free */
+      __sfp_release (fp);		/* set it free */
       ptr->_errno = e;		/* restore in case _close clobbered */
       if (!(oflags2 & __SNLK))
 	_funlockfile (fp);
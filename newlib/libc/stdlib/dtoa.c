@@ -174,6 +174,423 @@ quorem (_Bigint * b, _Bigint * S)
  */
 
 
+#if defined(IEEE_Arith) && !defined(_DOUBLE_IS_32BITS) \
+    && !defined(PREFER_SIZE_OVER_SPEED) && !defined(__OPTIMIZE_SIZE__)
+/*
+ * Fast path for modes 0, 2 and 3, after Florian Loitsch, "Printing
+ * Floating-Point Numbers Quickly and Accurately with Integers" (Grisu3),
+ * PLDI 2010.  The double is scaled by a cached 64-bit approximation of a
+ * power of ten so that its digits can be generated with integer
+ * arithmetic, while the accumulated error is tracked.  Whenever that
+ * error leaves any doubt about the last digit, fast_dtoa gives up and
+ * the Bigint code below has the final word, so results never differ.
+ */
+
+#define FAST_DTOA
+
+typedef struct
+{
+  __uint64_t f;
+  int e;
+} diy_fp;
+
+static const struct
+{
+  __uint64_t f;
+  short e;
+  short k;
+} cached_pow10[] = {		/* 10^k ~= f * 2^e, k = -348, -340, ... 340 */
+  { 0xfa8fd5a0081c0288ULL, -1220, -348 },
+  { 0xbaaee17fa23ebf76ULL, -1193, -340 },
+  { 0x8b16fb203055ac76ULL, -1166, -332 },
+  { 0xcf42894a5dce35eaULL, -1140, -324 },
+  { 0x9a6bb0aa55653b2dULL, -1113, -316 },
+  { 0xe61acf033d1a45dfULL, -1087, -308 },
+  { 0xab70fe17c79ac6caULL, -1060, -300 },
+  { 0xff77b1fcbebcdc4fULL, -1034, -292 },
+  { 0xbe5691ef416bd60cULL, -1007, -284 },
+  { 0x8dd01fad907ffc3cULL,  -980, -276 },
+  { 0xd3515c2831559a83ULL,  -954, -268 },
+  { 0x9d71ac8fada6c9b5ULL,  -927, -260 },
+  { 0xea9c227723ee8bcbULL,  -901, -252 },
+  { 0xaecc49914078536dULL,  -874, -244 },
+  { 0x823c12795db6ce57ULL,  -847, -236 },
+  { 0xc21094364dfb5637ULL,  -821, -228 },
+  { 0x9096ea6f3848984fULL,  -794, -220 },
+  { 0xd77485cb25823ac7ULL,  -768, -212 },
+  { 0xa086cfcd97bf97f4ULL,  -741, -204 },
+  { 0xef340a98172aace5ULL,  -715, -196 },
+  { 0xb23867fb2a35b28eULL,  -688, -188 },
+  { 0x84c8d4dfd2c63f3bULL,  -661, -180 },
+  { 0xc5dd44271ad3cdbaULL,  -635, -172 },
+  { 0x936b9fcebb25c996ULL,  -608, -164 },
+  { 0xdbac6c247d62a584ULL,  -582, -156 },
+  { 0xa3ab66580d5fdaf6ULL,  -555, -148 },
+  { 0xf3e2f893dec3f126ULL,  -529, -140 },
+  { 0xb5b5ada8aaff80b8ULL,  -502, -132 },
+  { 0x87625f056c7c4a8bULL,  -475, -124 },
+  { 0xc9bcff6034c13053ULL,  -449, -116 },
+  { 0x964e858c91ba2655ULL,  -422, -108 },
+  { 0xdff9772470297ebdULL,  -396, -100 },
+  { 0xa6dfbd9fb8e5b88fULL,  -369,  -92 },
+  { 0xf8a95fcf88747d94ULL,  -343,  -84 },
+  { 0xb94470938fa89bcfULL,  -316,  -76 },
+  { 0x8a08f0f8bf0f156bULL,  -289,  -68 },
+  { 0xcdb02555653131b6ULL,  -263,  -60 },
+  { 0x993fe2c6d07b7facULL,  -236,  -52 },
+  { 0xe45c10c42a2b3b06ULL,  -210,  -44 },
+  { 0xaa242499697392d3ULL,  -183,  -36 },
+  { 0xfd87b5f28300ca0eULL,  -157,  -28 },
+  { 0xbce5086492111aebULL,  -130,  -20 },
+  { 0x8cbccc096f5088ccULL,  -103,  -12 },
+  { 0xd1b71758e219652cULL,   -77,   -4 },
+  { 0x9c40000000000000ULL,   -50,    4 },
+  { 0xe8d4a51000000000ULL,   -24,   12 },
+  { 0xad78ebc5ac620000ULL,     3,   20 },
+  { 0x813f3978f8940984ULL,    30,   28 },
+  { 0xc097ce7bc90715b3ULL,    56,   36 },
+  { 0x8f7e32ce7bea5c70ULL,    83,   44 },
+  { 0xd5d238a4abe98068ULL,   109,   52 },
+  { 0x9f4f2726179a2245ULL,   136,   60 },
+  { 0xed63a231d4c4fb27ULL,   162,   68 },
+  { 0xb0de65388cc8ada8ULL,   189,   76 },
+  { 0x83c7088e1aab65dbULL,   216,   84 },
+  { 0xc45d1df942711d9aULL,   242,   92 },
+  { 0x924d692ca61be758ULL,   269,  100 },
+  { 0xda01ee641a708deaULL,   295,  108 },
+  { 0xa26da3999aef774aULL,   322,  116 },
+  { 0xf209787bb47d6b85ULL,   348,  124 },
+  { 0xb454e4a179dd1877ULL,   375,  132 },
+  { 0x865b86925b9bc5c2ULL,   402,  140 },
+  { 0xc83553c5c8965d3dULL,   428,  148 },
+  { 0x952ab45cfa97a0b3ULL,   455,  156 },
+  { 0xde469fbd99a05fe3ULL,   481,  164 },
+  { 0xa59bc234db398c25ULL,   508,  172 },
+  { 0xf6c69a72a3989f5cULL,   534,  180 },
+  { 0xb7dcbf5354e9beceULL,   561,  188 },
+  { 0x88fcf317f22241e2ULL,   588,  196 },
+  { 0xcc20ce9bd35c78a5ULL,   614,  204 },
+  { 0x98165af37b2153dfULL,   641,  212 },
+  { 0xe2a0b5dc971f303aULL,   667,  220 },
+  { 0xa8d9d1535ce3b396ULL,   694,  228 },
+  { 0xfb9b7cd9a4a7443cULL,   720,  236 },
+  { 0xbb764c4ca7a44410ULL,   747,  244 },
+  { 0x8bab8eefb6409c1aULL,   774,  252 },
+  { 0xd01fef10a657842cULL,   800,  260 },
+  { 0x9b10a4e5e9913129ULL,   827,  268 },
+  { 0xe7109bfba19c0c9dULL,   853,  276 },
+  { 0xac2820d9623bf429ULL,   880,  284 },
+  { 0x80444b5e7aa7cf85ULL,   907,  292 },
+  { 0xbf21e44003acdd2dULL,   933,  300 },
+  { 0x8e679c2f5e44ff8fULL,   960,  308 },
+  { 0xd433179d9c8cb841ULL,   986,  316 },
+  { 0x9e19db92b4e31ba9ULL,  1013,  324 },
+  { 0xeb96bf6ebadf77d9ULL,  1039,  332 },
+  { 0xaf87023b9bf0ee6bULL,  1066,  340 }
+};
+
+#define N_CACHED_POW10	(sizeof (cached_pow10) / sizeof (cached_pow10[0]))
+
+/* Scaled values have their binary exponent in [ALPHA, GAMMA], so that
+   the integral part fits in 32 bits and digits come out of the fraction
+   with a single multiplication by ten.  */
+#define ALPHA	(-60)
+#define GAMMA	(-32)
+
+/* Upper 64 bits of the 128-bit product, rounded.  */
+static diy_fp
+diy_mult (diy_fp x, diy_fp y)
+{
+  __uint64_t a = x.f >> 32, b = x.f & 0xffffffff;
+  __uint64_t c = y.f >> 32, d = y.f & 0xffffffff;
+  __uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  __uint64_t t = (bd >> 32) + (ad & 0xffffffff) + (bc & 0xffffffff)
+		 + ((__uint64_t) 1 << 31);
+  diy_fp r;
+
+  r.f = ac + (ad >> 32) + (bc >> 32) + (t >> 32);
+  r.e = x.e + y.e + 64;
+  return r;
+}
+
+static diy_fp
+diy_normalize (diy_fp x)
+{
+  while (!(x.f & ((__uint64_t) 1 << 63)))
+    {
+      x.f <<= 1;
+      x.e--;
+    }
+  return x;
+}
+
+/* Return an approximation of 10^mk that brings a number with binary
+   exponent e into [ALPHA, GAMMA], and set *mk.  */
+static diy_fp
+cached_power (int e, int *mk)
+{
+  diy_fp c;
+  int i;
+
+  /* Estimate ceil ((ALPHA - e - 1) * log10 (2)), then settle.  */
+  i = ((ALPHA - e - 1) * 78913 + (1 << 18) - 1) >> 18;
+  i = (i + 348 - 1) / 8 + 1;
+  if (i < 0)
+    i = 0;
+  if (i >= (int) N_CACHED_POW10)
+    i = N_CACHED_POW10 - 1;
+  while (i < (int) N_CACHED_POW10 - 1 && e + cached_pow10[i].e + 64 < ALPHA)
+    i++;
+  while (i > 0 && e + cached_pow10[i].e + 64 > GAMMA)
+    i--;
+  c.f = cached_pow10[i].f;
+  c.e = cached_pow10[i].e;
+  *mk = cached_pow10[i].k;
+  return c;
+}
+
+/* Set *divisor to the largest power of ten not above n, and return the
+   number of digits of n.  */
+static int
+biggest_pow10 (__uint32_t n, __uint32_t *divisor)
+{
+  __uint32_t p = 1;
+  int digits = 1;
+
+  while (digits < 10 && p * 10 <= n)
+    {
+      p *= 10;
+      digits++;
+    }
+  *divisor = p;
+  return digits;
+}
+
+/* Move the last digit of the shortest candidate towards w while that
+   stays inside the safe interval, then check that the result is
+   unambiguous.  All quantities are in units of the scaled exponent.  */
+static int
+round_weed (char *buf, int len, __uint64_t dist_high_w,
+	    __uint64_t unsafe, __uint64_t rest, __uint64_t ten_kappa,
+	    __uint64_t unit)
+{
+  __uint64_t small_dist = dist_high_w - unit;
+  __uint64_t big_dist = dist_high_w + unit;
+
+  while (rest < small_dist && unsafe - rest >= ten_kappa
+	 && (rest + ten_kappa < small_dist
+	     || small_dist - rest >= rest + ten_kappa - small_dist))
+    {
+      buf[len - 1]--;
+      rest += ten_kappa;
+    }
+  if (rest < big_dist && unsafe - rest >= ten_kappa
+      && (rest + ten_kappa < big_dist
+	  || big_dist - rest > rest + ten_kappa - big_dist))
+    return 0;
+  return 2 * unit <= rest && rest <= unsafe - 4 * unit;
+}
+
+/* Round the counted digits in buf according to the remainder rest,
+   which is known to within unit; give up if that is not enough.  */
+static int
+round_weed_counted (char *buf, int len, __uint64_t rest,
+		    __uint64_t ten_kappa, __uint64_t unit, int *kappa)
+{
+  int i;
+
+  if (unit >= ten_kappa || ten_kappa - unit <= unit)
+    return 0;
+  if (ten_kappa - rest > rest && ten_kappa - 2 * rest >= 2 * unit)
+    return 1;
+  if (rest > unit && ten_kappa - (rest - unit) <= rest - unit)
+    {
+      buf[len - 1]++;
+      for (i = len - 1; i > 0 && buf[i] == '0' + 10; i--)
+	{
+	  buf[i] = '0';
+	  buf[i - 1]++;
+	}
+      if (buf[0] == '0' + 10)
+	{
+	  buf[0] = '1';
+	  (*kappa)++;
+	}
+      return 1;
+    }
+  return 0;
+}
+
+/*
+ * An odd b times 2^e2 is a boundary of the rounding interval of a double
+ * with an even significand; mode 0 accepts boundaries in that case, which
+ * Grisu does not.  Return nonzero if the boundary might be a decimal with
+ * fewer than len significant digits, the len digits found having decpt
+ * digits before the point.  Only integral boundaries can be that short,
+ * and the boundary may have one digit fewer than the number itself.
+ */
+static int
+short_boundary (__uint64_t b, int e2, int decpt, int len)
+{
+  int t;
+
+  for (t = 0; t < e2 && b % 5 == 0; t++)
+    b /= 5;
+  return e2 >= 0 && t >= decpt - len;
+}
+
+/*
+ * Put the digits of d > 0 for the given mode (0, 2 or 3) into buf, with
+ * no terminator, and set *decpt.  Return the number of digits, or 0 if
+ * the result cannot be guaranteed and the caller must do it the slow way.
+ */
+static int
+fast_dtoa (double dd, int mode, int ndigits, char *buf, int *decpt)
+{
+  union double_union u;
+  diy_fp w, m_plus, m_minus, c, sw, too_low, too_high, one;
+  __uint64_t f, unsafe, fractionals, rest, unit;
+  __uint32_t integrals, divisor;
+  int e, mk, kappa, len, want, lower_closer;
+
+  u.d = dd;
+  w.f = ((__uint64_t) (word0 (u) & Frac_mask) << 32) | word1 (u);
+  w.e = (int) (word0 (u) >> Exp_shift1) - (Bias + P - 1);
+  if (word0 (u) & Exp_mask)
+    w.f |= (__uint64_t) Exp_msk1 << 32;
+  else
+    w.e++;			/* denormal */
+  f = w.f;
+  e = w.e;
+  lower_closer = !(word0 (u) & Frac_mask) && !word1 (u)
+		 && (word0 (u) & Exp_mask) > Exp_msk1;
+
+  if (mode == 0)
+    {
+      m_plus.f = (w.f << 1) + 1;
+      m_plus.e = w.e - 1;
+      m_plus = diy_normalize (m_plus);
+      if (lower_closer)
+	{
+	  m_minus.f = (w.f << 2) - 1;
+	  m_minus.e = w.e - 2;
+	}
+      else
+	{
+	  m_minus.f = (w.f << 1) - 1;
+	  m_minus.e = w.e - 1;
+	}
+      m_minus.f <<= m_minus.e - m_plus.e;
+      m_minus.e = m_plus.e;
+    }
+  w = diy_normalize (w);
+  c = cached_power (w.e, &mk);
+  sw = diy_mult (w, c);
+  one.e = sw.e;
+  one.f = (__uint64_t) 1 << -one.e;
+
+  if (mode == 0)
+    {
+      /* Digits of the upper bound, until we are inside the safe
+	 interval; then weed out the last one.  */
+      unit = 1;
+      too_low = diy_mult (m_minus, c);
+      too_high = diy_mult (m_plus, c);
+      too_low.f -= unit;
+      too_high.f += unit;
+      unsafe = too_high.f - too_low.f;
+      integrals = (__uint32_t) (too_high.f >> -one.e);
+      fractionals = too_high.f & (one.f - 1);
+      kappa = biggest_pow10 (integrals, &divisor);
+      len = 0;
+      for (;;)
+	{
+	  if (kappa > 0)
+	    {
+	      buf[len++] = '0' + integrals / divisor;
+	      integrals %= divisor;
+	      kappa--;
+	      rest = ((__uint64_t) integrals << -one.e) + fractionals;
+	      if (rest < unsafe)
+		{
+		  if (!round_weed (buf, len, too_high.f - sw.f, unsafe, rest,
+				   (__uint64_t) divisor << -one.e, unit))
+		    return 0;
+		  break;
+		}
+	      divisor /= 10;
+	    }
+	  else
+	    {
+	      fractionals *= 10;
+	      unit *= 10;
+	      unsafe *= 10;
+	      buf[len++] = '0' + (int) (fractionals >> -one.e);
+	      fractionals &= one.f - 1;
+	      kappa--;
+	      if (fractionals < unsafe)
+		{
+		  if (!round_weed (buf, len, (too_high.f - sw.f) * unit,
+				   unsafe, fractionals, one.f, unit))
+		    return 0;
+		  break;
+		}
+	    }
+	}
+      *decpt = kappa - mk + len;
+#ifndef ROUND_BIASED
+      if (!(f & 1)
+	  && (short_boundary ((f << 1) + 1, e - 1, *decpt, len)
+	      || short_boundary (lower_closer ? (f << 2) - 1 : (f << 1) - 1,
+				 e - 1 - lower_closer, *decpt, len)))
+	return 0;
+#endif
+      return len;
+    }
+
+  /* Counted digits: w is off by at most one unit.  */
+  integrals = (__uint32_t) (sw.f >> -one.e);
+  fractionals = sw.f & (one.f - 1);
+  kappa = biggest_pow10 (integrals, &divisor);
+  /* The first digit has weight 10^(kappa - 1 - mk).  */
+  want = mode == 2 ? ndigits : kappa - mk + ndigits;
+  if (want <= 0 || want > 17)
+    return 0;
+  unit = 1;
+  len = 0;
+  while (kappa > 0)
+    {
+      buf[len++] = '0' + integrals / divisor;
+      integrals %= divisor;
+      kappa--;
+      if (len == want)
+	{
+	  rest = ((__uint64_t) integrals << -one.e) + fractionals;
+	  if (!round_weed_counted (buf, len, rest,
+				   (__uint64_t) divisor << -one.e, unit,
+				   &kappa))
+	    return 0;
+	  *decpt = kappa - mk + len;
+	  return len;
+	}
+      divisor /= 10;
+    }
+  while (len < want && fractionals > unit)
+    {
+      fractionals *= 10;
+      unit *= 10;
+      buf[len++] = '0' + (int) (fractionals >> -one.e);
+      fractionals &= one.f - 1;
+      kappa--;
+    }
+  if (len < want
+      || !round_weed_counted (buf, len, fractionals, one.f, unit, &kappa))
+    return 0;
+  *decpt = kappa - mk + len;
+  return len;
+}
+#endif /* IEEE_Arith && !_DOUBLE_IS_32BITS && !PREFER_SIZE_OVER_SPEED ... */
+
 char *
 _dtoa_r (struct _reent *ptr,
 	double _d,
@@ -288,6 +705,39 @@ _dtoa_r (struct _reent *ptr,
       return s;
     }
 
+#ifdef FAST_DTOA
+  i = mode < 0 || mode > 9 ? 0 : mode;
+  if (i != 1 && i < 6)
+    {
+      char buf[20];
+
+      if (i > 3)
+	i -= 2;
+      if (i == 2 && ndigits <= 0)
+	ndigits = 1;
+      if ((j = fast_dtoa (d.d, i, ndigits, buf, decpt)) > 0)
+	{
+	  /* Leave room for the suppressed trailing zeros, as below.  */
+	  i = i == 0 ? 18 : i == 2 ? ndigits : ndigits + *decpt;
+	  if (i < j)
+	    i = j;
+	  j1 = sizeof (__ULong);
+	  for (_REENT_MP_RESULT_K(ptr) = 0;
+	       sizeof (_Bigint) - sizeof (__ULong) + j1 <= i; j1 <<= 1)
+	    _REENT_MP_RESULT_K(ptr)++;
+	  _REENT_MP_RESULT(ptr) = eBalloc (ptr, _REENT_MP_RESULT_K(ptr));
+	  s0 = (char *) _REENT_MP_RESULT(ptr);
+	  while (buf[j - 1] == '0')
+	    j--;
+	  memcpy (s0, buf, j);
+	  s0[j] = 0;
+	  if (rve)
+	    *rve = s0 + j;
+	  return s0;
+	}
+    }
+#endif
+
   b = d2b (ptr, d.d, &be, &bbits);
 #ifdef Sudden_Underflow
   i = (int) (word0 (d) >> Exp_shift1 & (Exp_mask >> Exp_shift1));
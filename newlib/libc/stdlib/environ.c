@@ -34,3 +34,11 @@ static char *initial_env[] = { 0 };
 /* Posix says `environ' is a pointer to a null terminated list of pointers.
    Hence `environ' itself is never NULL.  */
 char **environ = &initial_env[0];
+
+#ifdef __MSDOS__
+/* If set, this is called once, with the environment lock held, before the
+   first look-up in `environ'.  This lets the startup code leave `environ'
+   empty, and only build it if the program asks for it.  */
+struct _reent;
+void (*__env_fill_hook) (struct _reent *);
+#endif
@@ -57,6 +57,9 @@ permit '=' to be in identifiers.
 #include "envlock.h"
 
 extern char **environ;
+#ifdef __MSDOS__
+extern void (*__env_fill_hook) (struct _reent *);
+#endif
 
 /* Only deal with a pointer to environ, to work around subtle bugs with shared
    libraries and/or small data systems where the user declares his own
@@ -83,6 +86,15 @@ _findenv_r (struct _reent *reent_ptr,
 
   ENV_LOCK;
 
+#ifdef __MSDOS__
+  if (__env_fill_hook)
+    {
+      void (*hook) (struct _reent *) = __env_fill_hook;
+      __env_fill_hook = NULL;
+      (*hook) (reent_ptr);
+    }
+#endif
+
   /* In some embedded systems, this does not get set.  This protects
      newlib from dereferencing a bad pointer.  */
   if (!*p_environ)
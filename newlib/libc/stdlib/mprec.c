@@ -96,24 +96,66 @@
 #define _Kmax 15
 */
 
+/* The freelist heads of a reent are allocated together with a small arena
+   from which Bigints of up to 1 << ARENA_KMAX words are carved, enough for
+   the numbers involved in converting doubles of ordinary magnitude or with
+   up to about 20 significant digits.  The global reent's block is static,
+   so single-threaded programs reach malloc only for larger numbers.
+   Bigints larger than that are returned to the heap as soon as they are
+   freed; smaller ones stay on the freelists until _mprec_trim_r.  */
+
+union mp_unit
+{
+  struct _Bigint *_p;
+  __ULong _x;
+};
+
+#define BIGINT_UNITS(k) \
+  ((sizeof (_Bigint) + ((1 << (k)) - 1) * sizeof (__ULong) \
+    + sizeof (union mp_unit) - 1) / sizeof (union mp_unit))
+
+#define ARENA_KMAX	5
+#if defined(PREFER_SIZE_OVER_SPEED) || defined(__OPTIMIZE_SIZE__)
+#define ARENA_UNITS	(3 * BIGINT_UNITS (ARENA_KMAX))
+#else
+#define ARENA_UNITS	(15 * BIGINT_UNITS (ARENA_KMAX))
+#endif
+
+struct mp_block
+{
+  struct _Bigint *_freelist[_Kmax + 1];
+  int _used;				/* Units of _arena handed out.  */
+  union mp_unit _arena[ARENA_UNITS];
+};
+
+static struct mp_block global_block;
+
+#define IN_ARENA(b, v) \
+  ((char *) (v) >= (char *) (b)->_arena \
+   && (char *) (v) < (char *) ((b)->_arena + ARENA_UNITS))
+
 _Bigint *
 Balloc (struct _reent *ptr, int k)
 {
   int x;
   _Bigint *rv ;
+  struct mp_block *b;
 
   _REENT_CHECK_MP(ptr);
   if (_REENT_MP_FREELIST(ptr) == NULL)
     {
       /* Allocate a list of pointers to the mprec objects */
-      _REENT_MP_FREELIST(ptr) = (struct _Bigint **) _calloc_r (ptr, 
-						      sizeof (struct _Bigint *),
-						      _Kmax + 1);
-      if (_REENT_MP_FREELIST(ptr) == NULL)
+      if (ptr == _GLOBAL_REENT)
+	b = &global_block;
+      else
+	b = (struct mp_block *) _calloc_r (ptr, 1, sizeof (struct mp_block));
+      if (b == NULL)
 	{
 	  return NULL;
 	}
+      _REENT_MP_FREELIST(ptr) = b->_freelist;
     }
+  b = (struct mp_block *) _REENT_MP_FREELIST(ptr);
 
   if ((rv = _REENT_MP_FREELIST(ptr)[k]) != 0)
     {
@@ -122,12 +164,21 @@ Balloc (struct _reent *ptr, int k)
   else
     {
       x = 1 << k;
-      /* Allocate an mprec Bigint and stick in in the freelist */
-      rv = (_Bigint *) _calloc_r (ptr,
-				  1,
-				  sizeof (_Bigint) +
-				  (x-1) * sizeof(rv->_x));
-      if (rv == NULL) return NULL;
+      if (k <= ARENA_KMAX && b->_used + BIGINT_UNITS (k) <= ARENA_UNITS)
+	{
+	  /* Carve it out of the arena */
+	  rv = (_Bigint *) &b->_arena[b->_used];
+	  b->_used += BIGINT_UNITS (k);
+	}
+      else
+	{
+	  /* Allocate an mprec Bigint and stick in in the freelist */
+	  rv = (_Bigint *) _calloc_r (ptr,
+				      1,
+				      sizeof (_Bigint) +
+				      (x-1) * sizeof(rv->_x));
+	  if (rv == NULL) return NULL;
+	}
       rv->_k = k;
       rv->_maxwds = x;
     }
@@ -141,11 +192,66 @@ Bfree (struct _reent *ptr, _Bigint * v)
   _REENT_CHECK_MP(ptr);
   if (v)
     {
+      if (v->_k > ARENA_KMAX)
+	{
+	  _free_r (ptr, v);
+	  return;
+	}
       v->_next = _REENT_MP_FREELIST(ptr)[v->_k];
       _REENT_MP_FREELIST(ptr)[v->_k] = v;
     }
 }
 
+/*
+ * Give back to the heap the Bigints cached on the freelists of PTR.
+ * Those carved from the arena remain.
+ */
+void
+_mprec_trim_r (struct _reent *ptr)
+{
+  struct mp_block *b;
+  _Bigint **vp, *v;
+  int k;
+
+#ifdef _REENT_SMALL
+  if (ptr->_mp == NULL)
+    return;
+#endif
+  if ((b = (struct mp_block *) _REENT_MP_FREELIST(ptr)) == NULL)
+    return;
+  for (k = 0; k <= ARENA_KMAX; k++)
+    for (vp = &b->_freelist[k]; (v = *vp) != NULL; )
+      if (IN_ARENA (b, v))
+	vp = &v->_next;
+      else
+	{
+	  *vp = v->_next;
+	  _free_r (ptr, v);
+	}
+}
+
+/*
+ * Release all the Bigint storage of PTR, which is going away.
+ */
+void
+__mprec_reclaim (struct _reent *ptr)
+{
+  struct mp_block *b;
+
+  if ((b = (struct mp_block *) _REENT_MP_FREELIST(ptr)) == NULL)
+    return;
+  if (_REENT_MP_RESULT(ptr))
+    {
+      _REENT_MP_RESULT(ptr)->_k = _REENT_MP_RESULT_K(ptr);
+      Bfree (ptr, _REENT_MP_RESULT(ptr));
+      _REENT_MP_RESULT(ptr) = 0;
+    }
+  _mprec_trim_r (ptr);
+  if (b != &global_block)
+    _free_r (ptr, b);
+  _REENT_MP_FREELIST(ptr) = 0;
+}
+
 _Bigint *
 multadd (struct _reent *ptr,
 	_Bigint * b,
@@ -364,6 +364,7 @@ double 		ulp (double x);
 double		b2d (_Bigint *a , int *e);
 _Bigint *	Balloc (struct _reent *p, int k);
 void 		Bfree (struct _reent *p, _Bigint *v);
+void		__mprec_reclaim (struct _reent *p);
 _Bigint *	multadd (struct _reent *p, _Bigint *, int, int);
 _Bigint *	s2b (struct _reent *, const char*, int, int, __ULong);
 _Bigint	*	i2b (struct _reent *,int);
@@ -0,0 +1,70 @@
+/*
+ * Test program for qsort().
+ *
+ * Input that is already in order, or in reverse order, must be sorted
+ * in a linear number of comparisons, as it was before qsort learned to
+ * fall back to heapsort on bad partitions.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#define	TEST(e)	((e) ? (void)0 : testfail(__FILE__, __LINE__, #e))
+
+#define	N	1000
+/* Sorted input takes about 3 * N comparisons and reversed about 4 * N. */
+#define	MAXCMP	(5UL * N)
+
+static int vals[N];
+static unsigned long ncmp;
+
+static void
+testfail(const char *file, unsigned long line, const char *expression)
+{
+
+	fprintf(stderr, "TEST FAILED: %s: file %s, line %ld\n",
+	    expression, file, line);
+	exit(1);
+}
+
+static int
+compare(const void *a, const void *b)
+{
+	int x = *(const int *)a, y = *(const int *)b;
+
+	ncmp++;
+	return x < y ? -1 : x > y;
+}
+
+static int
+sorted(void)
+{
+	int i;
+
+	for (i = 0; i < N; i++)
+		if (vals[i] != i)
+			return 0;
+	return 1;
+}
+
+int
+main(void)
+{
+	int i;
+
+	for (i = 0; i < N; i++)
+		vals[i] = i;
+	ncmp = 0;
+	qsort(vals, N, sizeof vals[0], compare);
+	TEST(sorted());
+	TEST(ncmp <= MAXCMP);
+
+	for (i = 0; i < N; i++)
+		vals[i] = N - 1 - i;
+	ncmp = 0;
+	qsort(vals, N, sizeof vals[0], compare);
+	TEST(sorted());
+	TEST(ncmp <= MAXCMP);
+
+	return 0;
+}
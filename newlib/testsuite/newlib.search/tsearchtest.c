@@ -0,0 +1,129 @@
+/*
+ * Test program for tsearch() et al.
+ *
+ * Keys are inserted in ascending order, which used to degrade the tree
+ * into a list, and then in a scrambled order interleaved with deletions.
+ * After each phase the tree must still be in order and no deeper than a
+ * balanced tree of that size can be.
+ */
+
+#include <search.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#define	TEST(e)	((e) ? (void)0 : testfail(__FILE__, __LINE__, #e))
+
+#define	N	1000
+/* An AVL tree of N nodes has fewer than 1.44 * log2(N + 2) levels. */
+#define	MAXLEVEL 14
+
+static int vals[N];
+static int present[N];
+static int count, last, maxlevel, inorder;
+
+static void
+testfail(const char *file, unsigned long line, const char *expression)
+{
+
+	fprintf(stderr, "TEST FAILED: %s: file %s, line %ld\n",
+	    expression, file, line);
+	exit(1);
+}
+
+static int
+compar(const void *a, const void *b)
+{
+	int x = *(const int *)a, y = *(const int *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static void
+action(const void *node, VISIT order, int level)
+{
+	int v = **(int **)node;
+
+	if (level > maxlevel)
+		maxlevel = level;
+	if (order == postorder || order == leaf) {
+		if (v <= last)
+			inorder = 0;
+		last = v;
+		count++;
+	}
+}
+
+static void
+free_nothing(void *key)
+{
+}
+
+static int
+walk(void *root)
+{
+	count = 0;
+	last = -1;
+	maxlevel = 0;
+	inorder = 1;
+	twalk(root, action);
+	return count;
+}
+
+int
+main(void)
+{
+	void *root = NULL;
+	void *p;
+	int i, k, n;
+
+	for (i = 0; i < N; i++)
+		vals[i] = i;
+
+	/* Sorted insertions. */
+	for (i = 0; i < N; i++) {
+		p = tsearch(&vals[i], &root, compar);
+		TEST(p != NULL && *(int **)p == &vals[i]);
+	}
+	TEST(walk(root) == N);
+	TEST(inorder);
+	TEST(maxlevel <= MAXLEVEL);
+
+	/* Duplicates are found, not inserted. */
+	k = 17;
+	p = tsearch(&k, &root, compar);
+	TEST(p != NULL && *(int **)p == &vals[17]);
+	TEST(walk(root) == N);
+
+	/* Delete everything in ascending order too. */
+	for (i = 0; i < N; i++) {
+		TEST(tdelete(&vals[i], &root, compar) != NULL);
+		TEST(tfind(&vals[i], &root, compar) == NULL);
+	}
+	TEST(root == NULL);
+	TEST(tdelete(&vals[0], &root, compar) == NULL);
+
+	/* Scrambled insertions and deletions. */
+	n = 0;
+	for (i = 0; i < 4 * N; i++) {
+		k = (i * 7919) % N;
+		if ((i / 3) % 4 == 3) {
+			p = tdelete(&vals[k], &root, compar);
+			TEST((p != NULL) == present[k]);
+			n -= present[k];
+			present[k] = 0;
+		} else {
+			p = tsearch(&vals[k], &root, compar);
+			TEST(p != NULL && **(int **)p == k);
+			n += !present[k];
+			present[k] = 1;
+		}
+	}
+	TEST(walk(root) == n);
+	TEST(inorder);
+	TEST(maxlevel <= MAXLEVEL);
+	for (k = 0; k < N; k++)
+		TEST((tfind(&vals[k], &root, compar) != NULL) == present[k]);
+
+	tdestroy(root, free_nothing);
+	exit(0);
+}
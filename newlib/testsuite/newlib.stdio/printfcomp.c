@@ -0,0 +1,56 @@
+/*
+ * Test program for printf_compile and fprintf_compiled.
+ *
+ * A compiled format must print exactly what printf prints for the same
+ * format and arguments.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "check.h"
+
+static char want[64];
+static char got[64];
+
+static void
+compare (const char *fmt, ...)
+{
+  printf_fmt_t *pf;
+  va_list ap;
+  FILE *f;
+  int n;
+
+  pf = printf_compile (fmt);
+  CHECK (pf != NULL);
+
+  va_start (ap, fmt);
+  vsnprintf (want, sizeof want, fmt, ap);
+  va_end (ap);
+
+  memset (got, 0, sizeof got);
+  f = fmemopen (got, sizeof got, "w");
+  CHECK (f != NULL);
+  va_start (ap, fmt);
+  n = vfprintf_compiled (f, pf, ap);
+  va_end (ap);
+  fclose (f);
+  free (pf);
+
+  if (strcmp (want, got) != 0)
+    printf ("\"%s\": printf gave \"%s\", compiled gave \"%s\"\n",
+	    fmt, want, got);
+  CHECK (strcmp (want, got) == 0);
+  CHECK (n == (int) strlen (want));
+}
+
+int main()
+{
+  compare ("[%d][%5u][%-4x][%#o]", -12, 34u, 0xabu, 8u);
+  compare ("[%s][%.2s][%8s]", "abc", "xyz", "r");
+  compare ("[%c][%%][%*d][%.*d]", 'q', 6, 7, 3, 5);
+  /* A null pointer.  */
+  compare ("[%p][%10p][%-6p]", (void *) 0, (void *) 0, (void *) 0);
+  compare ("[%p]", (void *) want);
+  exit (0);
+}
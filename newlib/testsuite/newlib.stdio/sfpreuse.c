@@ -0,0 +1,61 @@
+/*
+ * Test program for FILE slot reuse in __sfp.
+ *
+ * Closed streams must be handed out again before new glue is allocated,
+ * and no slot may be handed out to two open streams.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "check.h"
+
+#define N 40
+
+static char buf[N][8];
+static FILE *fp[N];
+
+int main()
+{
+  FILE *f;
+  int i, j;
+
+  for (i = 0; i < N; i++)
+    {
+      fp[i] = fmemopen (buf[i], sizeof buf[i], "w");
+      CHECK (fp[i] != NULL);
+      for (j = 0; j < i; j++)
+	CHECK (fp[i] != fp[j]);
+    }
+
+  /* A closed slot comes back before any new one.  */
+  f = fp[N / 2];
+  fclose (f);
+  fp[N / 2] = fmemopen (buf[N / 2], sizeof buf[N / 2], "w");
+  CHECK (fp[N / 2] == f);
+
+  for (i = 0; i < N; i += 2)
+    fclose (fp[i]);
+  for (i = 0; i < N; i += 2)
+    {
+      fp[i] = fmemopen (buf[i], sizeof buf[i], "w");
+      CHECK (fp[i] != NULL);
+      for (j = 1; j < N; j += 2)
+	CHECK (fp[i] != fp[j]);
+      for (j = 0; j < i; j += 2)
+	CHECK (fp[i] != fp[j]);
+    }
+
+  for (i = 0; i < N; i++)
+    {
+      fprintf (fp[i], "%d", i);
+      fclose (fp[i]);
+    }
+  for (i = 0; i < N; i++)
+    {
+      char want[8];
+
+      sprintf (want, "%d", i);
+      CHECK (strcmp (buf[i], want) == 0);
+    }
+  exit (0);
+}